@@ -0,0 +1,184 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+//////////////////////////////////
+// batched queries
+// run many closed_star/open_star/link/vertex_one_ring queries in parallel chunks and
+// return all results in one CSR structure instead of one SimplicialComplex per query
+//////////////////////////////////
+enum class QueryKind
+{
+    ClosedStar,
+    OpenStar,
+    Link,
+    VertexOneRing
+};
+
+/**
+ * @brief queries stored as structure of arrays, query i is Simplex(dimensions[i], tuples[i])
+ */
+struct SimplexQueries
+{
+    std::vector<int> dimensions;
+    std::vector<Tuple> tuples;
+
+    size_t size() const { return dimensions.size(); }
+
+    void push_back(const int &d, const Tuple &t)
+    {
+        dimensions.push_back(d);
+        tuples.push_back(t);
+    }
+};
+
+/**
+ * @brief results of query i are ids[offsets[i]] ... ids[offsets[i + 1] - 1], sorted
+ */
+struct CsrResult
+{
+    std::vector<size_t> offsets;
+    std::vector<SimplexId> ids;
+};
+
+namespace detail
+{
+    // scratch buffers reused by all queries of a chunk
+    struct QueryScratch
+    {
+        std::vector<Simplex> cell_faces;
+        std::vector<SimplexId> faces;
+        std::vector<long> s_vertices;
+        std::vector<Tuple> cells;
+        CellTraversal traversal;
+    };
+
+    // each query is a full traversal of the cells around a simplex, so chunks are kept small
+    constexpr size_t query_grain_size = 16;
+
+    inline void append_vertex_ids(const Simplex &s, const Mesh &m, std::vector<SimplexId> &faces, std::vector<long> &out)
+    {
+        faces.clear();
+        append_simplex_with_boundary(s, m, faces);
+        out.clear();
+        for (const SimplexId &f : faces)
+        {
+            if (f.dimension() == 0)
+            {
+                out.push_back(f.global_id());
+            }
+        }
+    }
+
+    /**
+     * @brief append the sorted result of one query to _out_, same definitions as the single-simplex operators
+     */
+    inline void append_query_result(const Simplex &s, const QueryKind &kind, const Mesh &m, QueryScratch &scratch, std::vector<SimplexId> &out)
+    {
+        const int &cell_dim = m.cell_dimension();
+        const size_t first = out.size();
+
+        append_vertex_ids(s, m, scratch.faces, scratch.s_vertices);
+        const auto shares_vertex_with_s = [&](const Simplex &ss) {
+            scratch.faces.clear();
+            append_simplex_with_boundary(ss, m, scratch.faces);
+            return std::any_of(scratch.faces.begin(), scratch.faces.end(), [&](const SimplexId &f) {
+                return f.dimension() == 0 &&
+                       std::find(scratch.s_vertices.begin(), scratch.s_vertices.end(), f.global_id()) != scratch.s_vertices.end();
+            });
+        };
+
+        if (kind == QueryKind::OpenStar)
+        {
+            out.emplace_back(s);
+        }
+        scratch.cells.clear();
+        append_top_cofaces(s, m, scratch.traversal, scratch.cells);
+        for (const Tuple &t : scratch.cells)
+        {
+            scratch.cell_faces.clear();
+            append_simplex_with_boundary(Simplex(cell_dim, t), m, scratch.cell_faces);
+            for (const Simplex &ss : scratch.cell_faces)
+            {
+                switch (kind)
+                {
+                case QueryKind::ClosedStar:
+                    out.emplace_back(ss);
+                    break;
+                case QueryKind::OpenStar:
+                    if (ss.dimension() > s.dimension() && shares_vertex_with_s(ss))
+                    {
+                        out.emplace_back(ss);
+                    }
+                    break;
+                case QueryKind::Link:
+                    if (!shares_vertex_with_s(ss))
+                    {
+                        out.emplace_back(ss);
+                    }
+                    break;
+                case QueryKind::VertexOneRing:
+                    if (ss.dimension() == 0 && !shares_vertex_with_s(ss))
+                    {
+                        out.emplace_back(ss);
+                    }
+                    break;
+                }
+            }
+        }
+
+        std::sort(out.begin() + first, out.end());
+        out.erase(std::unique(out.begin() + first, out.end()), out.end());
+    }
+} // namespace detail
+
+/**
+ * @brief run the same operator on every query
+ *
+ * Queries are processed in parallel chunks, each appending to one chunk buffer and reusing
+ * one set of traversal buffers. The output
+ * ids are allocated once, after the offsets are known, and the chunk buffers are copied in parallel.
+ */
+inline CsrResult batch_query(const SimplexQueries &queries, const QueryKind &kind, const Mesh &m)
+{
+    assert(queries.dimensions.size() == queries.tuples.size());
+    const size_t n = queries.size();
+    const size_t n_chunks = parallel_chunk_count(n, detail::query_grain_size);
+
+    CsrResult ret;
+    ret.offsets.assign(n + 1, 0);
+
+    std::vector<std::vector<SimplexId>> buffers(n_chunks);
+    std::vector<size_t> chunk_begin(n_chunks, n);
+    parallel_for(n, [&](size_t begin, size_t end, size_t chunk_id) {
+        chunk_begin[chunk_id] = begin;
+        detail::QueryScratch scratch;
+        std::vector<SimplexId> &buffer = buffers[chunk_id];
+        for (size_t i = begin; i < end; ++i)
+        {
+            assert(kind != QueryKind::VertexOneRing || queries.dimensions[i] == 0);
+            const size_t before = buffer.size();
+            detail::append_query_result(Simplex(queries.dimensions[i], queries.tuples[i]), kind, m, scratch, buffer);
+            ret.offsets[i + 1] = buffer.size() - before;
+        }
+    }, detail::query_grain_size);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        ret.offsets[i + 1] += ret.offsets[i];
+    }
+
+    ret.ids.resize(ret.offsets[n]);
+    parallel_for(n_chunks, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            if (buffers[c].empty())
+            {
+                continue;
+            }
+            std::copy(buffers[c].begin(), buffers[c].end(), ret.ids.begin() + ret.offsets[chunk_begin[c]]);
+        }
+    }, 1);
+
+    return ret;
+}
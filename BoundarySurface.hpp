@@ -0,0 +1,106 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+//////////////////////////////////
+// boundary surface of a tet mesh
+//////////////////////////////////
+struct BoundarySurface
+{
+    SimplicialComplex complex;              // boundary triangles with their edges and vertices
+    std::vector<long> vertices;             // compact vertex index -> global vertex id
+    std::vector<std::array<long, 3>> faces; // boundary triangles as compact vertex indices
+};
+
+/**
+ * @brief extract the boundary triangles of a tet mesh in one parallel pass over the cells
+ *
+ * Every boundary triangle belongs to exactly one tet, so triangles need no deduplication.
+ * Threads append to their own buffers, without per-face allocations; edges and vertices are
+ * deduplicated by one sort + unique of the packed ids. Triangles are oriented outward:
+ * (a, b, c, d) of a ccw tuple is positively oriented, so the normal of abc points into the
+ * tet, toward d, and the triangle is flipped.
+ */
+inline BoundarySurface extract_boundary_surface(const Mesh &m)
+{
+    assert(m.cell_dimension() == 3);
+    const long n_cells = m.simplex_count(3);
+    const size_t n_chunks = parallel_chunk_count(n_cells);
+
+    std::vector<std::vector<std::array<long, 3>>> chunk_faces(n_chunks);
+    std::vector<std::vector<SimplexId>> chunk_simplices(n_chunks);
+    parallel_for(n_cells, [&](size_t begin, size_t end, size_t chunk_id) {
+        std::vector<std::array<long, 3>> &faces = chunk_faces[chunk_id];
+        std::vector<SimplexId> &simplices = chunk_simplices[chunk_id];
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            const Tuple t = m.tuple_from_id(3, cell);
+            const std::array<Tuple, 4> facets = {t, t.sw(2, m), t.sw(1, m).sw(2, m), t.sw(0, m).sw(1, m).sw(2, m)};
+            for (const Tuple &f : facets)
+            {
+                if (!f.is_boundary(m))
+                {
+                    continue;
+                }
+                const Tuple a = f;
+                const Tuple b = f.sw(0, m);
+                const Tuple c = f.sw(1, m).sw(0, m);
+                if (m.is_ccw(f))
+                {
+                    faces.push_back({Simplex(0, a).global_id(), Simplex(0, c).global_id(), Simplex(0, b).global_id()});
+                }
+                else
+                {
+                    faces.push_back({Simplex(0, a).global_id(), Simplex(0, b).global_id(), Simplex(0, c).global_id()});
+                }
+                simplices.emplace_back(Simplex(2, f));
+                simplices.emplace_back(Simplex(1, f));
+                simplices.emplace_back(Simplex(1, f.sw(1, m)));
+                simplices.emplace_back(Simplex(1, b.sw(1, m)));
+                simplices.emplace_back(Simplex(0, a));
+                simplices.emplace_back(Simplex(0, b));
+                simplices.emplace_back(Simplex(0, c));
+            }
+        }
+        std::sort(simplices.begin(), simplices.end());
+        simplices.erase(std::unique(simplices.begin(), simplices.end()), simplices.end());
+    });
+
+    BoundarySurface ret;
+    ret.complex = SimplicialComplex::from_sorted(detail::parallel_merge_unique(std::move(chunk_simplices)));
+
+    // vertices come first in the sorted ids, their position is the compact index
+    for (const SimplexId &s : ret.complex.get_simplices())
+    {
+        if (s.dimension() > 0)
+        {
+            break;
+        }
+        ret.vertices.push_back(s.global_id());
+    }
+
+    size_t n_faces = 0;
+    std::vector<size_t> face_offsets(n_chunks + 1, 0);
+    for (size_t i = 0; i < n_chunks; ++i)
+    {
+        n_faces += chunk_faces[i].size();
+        face_offsets[i + 1] = n_faces;
+    }
+    ret.faces.resize(n_faces);
+    parallel_for(n_chunks, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            std::array<long, 3> *out = ret.faces.data() + face_offsets[i];
+            for (const std::array<long, 3> &f : chunk_faces[i])
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    (*out)[j] = std::lower_bound(ret.vertices.begin(), ret.vertices.end(), f[j]) - ret.vertices.begin();
+                }
+                ++out;
+            }
+        }
+    }, 1);
+
+    return ret;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+//////////////////////////////////
+// priority-queue edge collapse driver
+// pop the cheapest edge, check the link condition, collapse, update the neighbors
+//////////////////////////////////
+class EdgeCollapseDriver
+{
+public:
+    using CostFunction = std::function<double(const Tuple &, const Mesh &)>;
+
+    struct Stats
+    {
+        size_t n_collapses = 0;
+        size_t n_pops = 0;
+        size_t n_stale_pops = 0;               // outdated queue entries skipped
+        size_t n_link_cond_evaluations = 0;
+        size_t n_link_cond_cache_hits = 0;
+        size_t n_link_cond_rejections = 0;
+        double seconds = 0;
+
+        double collapses_per_second() const
+        {
+            return seconds > 0 ? n_collapses / seconds : 0;
+        }
+    };
+
+    EdgeCollapseDriver(Mesh &m, const CostFunction &cost) : _m{m}, _cost{cost} {}
+
+    /**
+     * @brief (re)schedule the edge in _t_ with its current cost
+     *
+     * Older queue entries of the same edge become stale and are skipped when popped.
+     */
+    void push(const Tuple &t)
+    {
+        const long id = Simplex(1, t).global_id();
+        const size_t version = ++_versions[id];
+        _queue.push(Entry{_cost(t, _m), id, version, t});
+    }
+
+    /**
+     * @brief collapse edges in cost order until the queue is empty or max_collapses is reached
+     */
+    Stats run(const size_t &max_collapses = std::numeric_limits<size_t>::max())
+    {
+        Stats stats;
+        const auto start = std::chrono::steady_clock::now();
+
+        while (!_queue.empty() && stats.n_collapses < max_collapses)
+        {
+            const Entry e = _queue.top();
+            _queue.pop();
+            ++stats.n_pops;
+
+            if (!_m.is_valid(e.t) || _versions[e.edge_id] != e.version)
+            {
+                ++stats.n_stale_pops;
+                continue;
+            }
+
+            if (!cached_link_cond(e, stats))
+            {
+                // dropped until a collapse in its neighborhood invalidates the verdict
+                ++stats.n_link_cond_rejections;
+                continue;
+            }
+
+            const Tuple v = _m.collapse_edge(e.t);
+            ++stats.n_collapses;
+            _link_cond_cache.erase(e.edge_id);
+            update_neighborhood(v);
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+private:
+    struct Entry
+    {
+        double cost;
+        long edge_id;
+        size_t version;
+        Tuple t;
+
+        // std::priority_queue is a max-heap, pop the cheapest edge first
+        bool operator<(const Entry &rhs) const { return cost > rhs.cost; }
+    };
+
+    bool cached_link_cond(const Entry &e, Stats &stats)
+    {
+        const auto it = _link_cond_cache.find(e.edge_id);
+        if (it != _link_cond_cache.end())
+        {
+            ++stats.n_link_cond_cache_hits;
+            return it->second;
+        }
+        ++stats.n_link_cond_evaluations;
+        const bool verdict = link_cond(e.t, _m);
+        _link_cond_cache[e.edge_id] = verdict;
+        return verdict;
+    }
+
+    /**
+     * @brief re-schedule the edges around the merged vertex _v_
+     *
+     * Let W be the vertices of closed_star(v). The link condition of an edge can only change if
+     * both of its endpoints are in W, so only those cached verdicts are dropped. Edges with one
+     * endpoint in W have a modified closed star and get a fresh cost but keep their verdict.
+     * W and the edges incident to it are read off the top cofaces, no complex is built.
+     */
+    void update_neighborhood(const Tuple &v)
+    {
+        const int &cell_dim = _m.cell_dimension();
+
+        // vertex id -> tuple pointing to it
+        std::unordered_map<long, Tuple> w;
+        for (const Tuple &c : top_cofaces(Simplex(0, v), _m))
+        {
+            std::vector<Tuple> vertices = {c, c.sw(0, _m), c.sw(1, _m).sw(0, _m)};
+            if (cell_dim == 3)
+            {
+                vertices.push_back(c.sw(2, _m).sw(1, _m).sw(0, _m));
+            }
+            for (const Tuple &t : vertices)
+            {
+                w.emplace(Simplex(0, t).global_id(), t);
+            }
+        }
+
+        // the edges at vertex A of a cell rooted at A: AB, AC (and AD)
+        std::unordered_map<long, Tuple> edges;
+        for (const auto &[w_id, w_tuple] : w)
+        {
+            for (const Tuple &c : top_cofaces(Simplex(0, w_tuple), _m))
+            {
+                edges.emplace(Simplex(1, c).global_id(), c);
+                edges.emplace(Simplex(1, c.sw(1, _m)).global_id(), c.sw(1, _m));
+                if (cell_dim == 3)
+                {
+                    edges.emplace(Simplex(1, c.sw(2, _m).sw(1, _m)).global_id(), c.sw(2, _m).sw(1, _m));
+                }
+            }
+        }
+
+        for (const auto &[id, t] : edges)
+        {
+            const bool is_spanned = w.count(Simplex(0, t).global_id()) > 0 &&
+                                    w.count(Simplex(0, t.sw(0, _m)).global_id()) > 0;
+            if (is_spanned)
+            {
+                _link_cond_cache.erase(id);
+            }
+            push(t);
+        }
+    }
+
+    Mesh &_m;
+    CostFunction _cost;
+    std::priority_queue<Entry> _queue;
+    std::unordered_map<long, size_t> _versions;      // edge id -> version of its latest queue entry
+    std::unordered_map<long, bool> _link_cond_cache; // edge id -> link condition verdict
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+
+//////////////////////////////////
+// conflict-free scheduling of local edge operations
+// an operation on edge ab reads and rewrites the closed stars of a and b, so two edges
+// conflict if these regions share a vertex
+//////////////////////////////////
+
+/**
+ * @brief global ids of the vertices in clst(a) ∪ clst(b) for the edge ab in _t_, sorted
+ *
+ * link_cond(ab) reads all of lnk(a) and lnk(b), and collapse_edge() rewrites every cell of
+ * st(a) ∪ st(b), so this is the region a link-condition-gated collapse touches.
+ */
+inline std::vector<long> closed_star_vertex_footprint(const Tuple &t, const Mesh &m)
+{
+    const int &cell_dim = m.cell_dimension();
+    std::vector<long> ret;
+    std::vector<SimplexId> faces;
+    for (const Tuple &v : {t, t.sw(0, m)})
+    {
+        for (const Tuple &c : top_cofaces(Simplex(0, v), m))
+        {
+            faces.clear();
+            append_simplex_with_boundary(Simplex(cell_dim, c), m, faces);
+            for (const SimplexId &f : faces)
+            {
+                if (f.dimension() == 0)
+                {
+                    ret.push_back(f.global_id());
+                }
+            }
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+namespace detail
+{
+    // splitmix64, used as a deterministic random priority
+    inline uint64_t schedule_priority(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief footprints of all edges, computed in parallel
+     */
+    inline std::vector<std::vector<long>> edge_footprints(const std::vector<Tuple> &edges, const Mesh &m)
+    {
+        std::vector<std::vector<long>> footprints(edges.size());
+        parallel_for(edges.size(), [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                footprints[i] = closed_star_vertex_footprint(edges[i], m);
+            }
+        });
+        return footprints;
+    }
+
+    /**
+     * @brief Jones-Plassmann rounds on the conflict graph of the footprints
+     *
+     * @returns batches of indices into _footprints_
+     */
+    inline std::vector<std::vector<size_t>> schedule_batches(const std::vector<std::vector<long>> &footprints)
+    {
+        const size_t n = footprints.size();
+
+        // vertex -> edges whose footprint contains it
+        std::unordered_map<long, std::vector<size_t>> vertex_edges;
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (const long &v : footprints[i])
+            {
+                vertex_edges[v].push_back(i);
+            }
+        }
+
+        std::vector<uint64_t> priority(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            priority[i] = schedule_priority(i);
+        }
+        const auto has_precedence = [&priority](const size_t &i, const size_t &j) {
+            return priority[i] > priority[j] || (priority[i] == priority[j] && i < j);
+        };
+
+        std::vector<char> is_scheduled(n, false);
+        std::vector<size_t> remaining(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            remaining[i] = i;
+        }
+
+        std::vector<std::vector<size_t>> batches;
+        while (!remaining.empty())
+        {
+            // is_scheduled is only read inside the parallel section
+            std::vector<char> is_selected(remaining.size(), false);
+            parallel_for(remaining.size(), [&](size_t begin, size_t end, size_t) {
+                for (size_t r = begin; r < end; ++r)
+                {
+                    const size_t i = remaining[r];
+                    bool is_local_max = true;
+                    for (const long &v : footprints[i])
+                    {
+                        for (const size_t &j : vertex_edges.at(v))
+                        {
+                            if (j != i && !is_scheduled[j] && has_precedence(j, i))
+                            {
+                                is_local_max = false;
+                                break;
+                            }
+                        }
+                        if (!is_local_max)
+                        {
+                            break;
+                        }
+                    }
+                    is_selected[r] = is_local_max;
+                }
+            });
+
+            std::vector<size_t> batch;
+            std::vector<size_t> next_remaining;
+            for (size_t r = 0; r < remaining.size(); ++r)
+            {
+                const size_t i = remaining[r];
+                if (is_selected[r])
+                {
+                    is_scheduled[i] = true;
+                    batch.push_back(i);
+                }
+                else
+                {
+                    next_remaining.push_back(i);
+                }
+            }
+            batches.push_back(std::move(batch));
+            remaining = std::move(next_remaining);
+        }
+
+        return batches;
+    }
+} // namespace detail
+
+/**
+ * @brief split edges into batches whose footprints do not overlap
+ *
+ * Footprints are computed in parallel. Batches are independent sets of the conflict graph,
+ * extracted in parallel rounds (Jones-Plassmann): in each round an edge joins the batch if its
+ * random priority is the largest among the not yet scheduled edges it conflicts with. The
+ * edges of one batch can be processed concurrently without locks.
+ *
+ * @returns batches in the order they should be processed
+ */
+inline std::vector<std::vector<Tuple>> schedule_edge_batches(const std::vector<Tuple> &edges, const Mesh &m)
+{
+    std::vector<std::vector<Tuple>> ret;
+    for (const std::vector<size_t> &batch : detail::schedule_batches(detail::edge_footprints(edges, m)))
+    {
+        ret.emplace_back();
+        for (const size_t &i : batch)
+        {
+            ret.back().push_back(edges[i]);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief a maximal set of edges with pairwise disjoint footprints
+ *
+ * Greedy completion of the first parallel batch, so no remaining candidate can be added.
+ * The footprints of the parallel pass are reused.
+ */
+inline std::vector<Tuple> independent_edge_set(const std::vector<Tuple> &edges, const Mesh &m)
+{
+    const std::vector<std::vector<long>> footprints = detail::edge_footprints(edges, m);
+    const std::vector<std::vector<size_t>> batches = detail::schedule_batches(footprints);
+    if (batches.empty())
+    {
+        return {};
+    }
+
+    std::vector<Tuple> ret;
+    std::set<long> used_vertices;
+    for (const size_t &i : batches[0])
+    {
+        ret.push_back(edges[i]);
+        used_vertices.insert(footprints[i].begin(), footprints[i].end());
+    }
+    for (size_t b = 1; b < batches.size(); ++b)
+    {
+        for (const size_t &i : batches[b])
+        {
+            const std::vector<long> &fp = footprints[i];
+            const bool is_free = std::none_of(fp.begin(), fp.end(), [&used_vertices](const long &v) {
+                return used_vertices.count(v) > 0;
+            });
+            if (is_free)
+            {
+                ret.push_back(edges[i]);
+                used_vertices.insert(fp.begin(), fp.end());
+            }
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+#include <atomic>
+
+//////////////////////////////////
+// mesh-wide manifoldness validation
+// every edge link must be a single path or cycle, every vertex link a single disk or sphere
+//////////////////////////////////
+struct ManifoldReport
+{
+    std::vector<long> non_manifold_vertices; // global ids, sorted
+    std::vector<long> non_manifold_edges;    // global ids, sorted
+
+    bool is_manifold() const { return non_manifold_vertices.empty() && non_manifold_edges.empty(); }
+};
+
+namespace detail
+{
+    /**
+     * @brief number of cells incident to every vertex and edge, in one parallel pass over the cells
+     */
+    inline std::array<std::vector<std::atomic<int>>, 2> incident_cell_counts(const Mesh &m)
+    {
+        const int &cell_dim = m.cell_dimension();
+        std::array<std::vector<std::atomic<int>>, 2> counts = {
+            std::vector<std::atomic<int>>(m.simplex_count(0)),
+            std::vector<std::atomic<int>>(m.simplex_count(1))};
+        for (auto &c : counts)
+        {
+            for (std::atomic<int> &x : c)
+            {
+                x.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        parallel_for(m.simplex_count(cell_dim), [&](size_t begin, size_t end, size_t) {
+            std::vector<SimplexId> faces;
+            for (size_t c = begin; c < end; ++c)
+            {
+                faces.clear();
+                append_simplex_with_boundary(Simplex(cell_dim, m.tuple_from_id(cell_dim, c)), m, faces);
+                for (const SimplexId &f : faces)
+                {
+                    if (f.dimension() <= 1)
+                    {
+                        counts[f.dimension()][f.global_id()].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+        return counts;
+    }
+
+    /**
+     * @brief merge per-thread id lists into one sorted list
+     */
+    inline std::vector<long> gather_sorted(std::vector<std::vector<long>> &per_thread)
+    {
+        std::vector<long> ret;
+        for (const std::vector<long> &v : per_thread)
+        {
+            ret.insert(ret.end(), v.begin(), v.end());
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+} // namespace detail
+
+/**
+ * @brief find all vertices and edges with a non-manifold link
+ *
+ * Connectivity: a link is connected iff the local traversal around the simplex reaches all of
+ * its incident cells, which are counted in one global pass. For a connected link the counts of
+ * link_counts() are enough:
+ * - edge of a tet mesh: the rotation already yields a single path or cycle
+ * - vertex of a triangle mesh: the link is a cycle (V == E) or a path (V == E + 1)
+ * - vertex of a tet mesh: the link is a sphere (no boundary, Euler characteristic 2) or a disk
+ *   (boundary, Euler characteristic 1)
+ */
+inline ManifoldReport validate_manifold(const Mesh &m)
+{
+    const int &cell_dim = m.cell_dimension();
+    const auto counts = detail::incident_cell_counts(m);
+
+    ManifoldReport report;
+
+    const long n_vertices = m.simplex_count(0);
+    std::vector<std::vector<long>> bad_vertices(parallel_chunk_count(n_vertices));
+    parallel_for(n_vertices, [&](size_t begin, size_t end, size_t chunk_id) {
+        for (size_t v = begin; v < end; ++v)
+        {
+            if (counts[0][v].load(std::memory_order_relaxed) == 0)
+            {
+                continue; // isolated or deleted vertex
+            }
+            const Simplex s(0, m.tuple_from_id(0, v));
+            const SimplexCounts lc = link_counts(s, m);
+            // the top dimension simplices of the link are in one-to-one correspondence with the cells around v
+            const bool is_connected = lc[cell_dim - 1] == counts[0][v].load(std::memory_order_relaxed);
+
+            bool is_manifold = is_connected;
+            if (is_manifold && cell_dim == 2)
+            {
+                const int chi = lc[0] - lc[1];
+                is_manifold = (chi == 0 || chi == 1);
+            }
+            else if (is_manifold && cell_dim == 3)
+            {
+                const int chi = lc[0] - lc[1] + lc[2];
+                const int n_boundary_faces = 2 * lc[1] - 3 * lc[2];
+                is_manifold = (n_boundary_faces == 0) ? (chi == 2) : (chi == 1);
+            }
+
+            if (!is_manifold)
+            {
+                bad_vertices[chunk_id].push_back(v);
+            }
+        }
+    });
+    report.non_manifold_vertices = detail::gather_sorted(bad_vertices);
+
+    const long n_edges = m.simplex_count(1);
+    std::vector<std::vector<long>> bad_edges(parallel_chunk_count(n_edges));
+    parallel_for(n_edges, [&](size_t begin, size_t end, size_t chunk_id) {
+        for (size_t e = begin; e < end; ++e)
+        {
+            const int n_cells = counts[1][e].load(std::memory_order_relaxed);
+            if (n_cells == 0)
+            {
+                continue;
+            }
+            const int n_reached = (cell_dim == 3) ? detail::tet_edge_fan(m.tuple_from_id(1, e), m).n_cells : std::min(n_cells, 2);
+            if (n_reached != n_cells)
+            {
+                bad_edges[chunk_id].push_back(e);
+            }
+        }
+    });
+    report.non_manifold_edges = detail::gather_sorted(bad_edges);
+
+    return report;
+}
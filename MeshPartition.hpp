@@ -0,0 +1,211 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+#include <unordered_map>
+
+//////////////////////////////////
+// partitioning with k-ring ghost layers
+// every part owns a set of cells and keeps read-only ghost copies of the cells
+// around its interface vertices, so local operators can run without communication
+//////////////////////////////////
+struct MeshPart
+{
+    std::vector<long> owned_cells; // global ids of the cells owned by this part
+    std::vector<long> ghost_cells; // global ids of the ghost cells, owned by other parts
+
+    /**
+     * per dimension: local id -> global id
+     * the simplices owned by this part come first, n_owned[d] of them; every simplex has a
+     * single owner, the lowest part among its incident cells
+     */
+    std::array<std::vector<long>, 4> local_to_global;
+    std::array<std::unordered_map<long, long>, 4> global_to_local;
+    std::array<long, 4> n_owned = {0, 0, 0, 0};
+};
+
+namespace detail
+{
+    /**
+     * @brief cells in BFS order over the dual graph, so contiguous chunks are connected
+     */
+    inline std::vector<long> dual_bfs_order(const Mesh &m)
+    {
+        const int &cell_dim = m.cell_dimension();
+        const long n_cells = m.simplex_count(cell_dim);
+        std::vector<char> is_visited(n_cells, false);
+        std::vector<long> order;
+        order.reserve(n_cells);
+
+        for (long seed = 0; seed < n_cells; ++seed)
+        {
+            if (is_visited[seed])
+            {
+                continue;
+            }
+            std::queue<Tuple> q;
+            q.push(m.tuple_from_id(cell_dim, seed));
+            is_visited[seed] = true;
+            while (!q.empty())
+            {
+                const Tuple t = q.front();
+                q.pop();
+                order.push_back(Simplex(cell_dim, t).global_id());
+                for (const Tuple &f : cell_facets(t, m))
+                {
+                    if (f.is_boundary(m))
+                    {
+                        continue;
+                    }
+                    const Tuple n = f.sw(cell_dim, m);
+                    const long n_id = Simplex(cell_dim, n).global_id();
+                    if (!is_visited[n_id])
+                    {
+                        is_visited[n_id] = true;
+                        q.push(n);
+                    }
+                }
+            }
+        }
+        return order;
+    }
+} // namespace detail
+
+/**
+ * @brief split the cells of m into n_parts parts, each with a ghost layer of depth ghost_depth
+ *
+ * Parts are contiguous chunks of a BFS order of the dual graph. The ghost region of a part is
+ * the closed star of all vertices within ghost_depth - 1 edges of its interface vertices, so
+ * with ghost_depth >= 1 the closed stars of both endpoints of any owned edge are available
+ * locally and link_cond can be evaluated without the other parts.
+ */
+inline std::vector<MeshPart> partition_mesh(const Mesh &m, const int &n_parts, const int &ghost_depth = 1)
+{
+    assert(n_parts >= 1);
+    assert(ghost_depth >= 1);
+    const int &cell_dim = m.cell_dimension();
+
+    const std::vector<long> order = detail::dual_bfs_order(m);
+    const long n_cells = order.size();
+    std::vector<int> cell_part(n_cells);
+    std::vector<MeshPart> parts(n_parts);
+    for (long i = 0; i < n_cells; ++i)
+    {
+        const int p = (i * n_parts) / n_cells;
+        cell_part[order[i]] = p;
+        parts[p].owned_cells.push_back(order[i]);
+    }
+
+    // simplex -> lowest part owning a cell around it, vertex -> all parts owning a cell around it
+    std::array<std::vector<int>, 4> owner;
+    for (int d = 0; d <= cell_dim; ++d)
+    {
+        owner[d].assign(m.simplex_count(d), n_parts);
+    }
+    std::unordered_map<long, std::vector<int>> vertex_parts;
+    std::vector<SimplexId> faces;
+    for (long c = 0; c < n_cells; ++c)
+    {
+        faces.clear();
+        append_simplex_with_boundary(Simplex(cell_dim, m.tuple_from_id(cell_dim, c)), m, faces);
+        for (const SimplexId &f : faces)
+        {
+            int &o = owner[f.dimension()][f.global_id()];
+            o = std::min(o, cell_part[c]);
+            if (f.dimension() == 0)
+            {
+                std::vector<int> &vp = vertex_parts[f.global_id()];
+                if (std::find(vp.begin(), vp.end(), cell_part[c]) == vp.end())
+                {
+                    vp.push_back(cell_part[c]);
+                }
+            }
+        }
+    }
+
+    parallel_for(n_parts, [&](size_t begin, size_t end, size_t) {
+        for (size_t p = begin; p < end; ++p)
+        {
+            MeshPart &part = parts[p];
+
+            // interface vertices, then ghost_depth - 1 rings around them
+            std::set<long> region_vertices;
+            std::vector<Tuple> frontier;
+            for (const long &c : part.owned_cells)
+            {
+                for (const long &v : detail::cell_vertex_ids(c, m))
+                {
+                    if (vertex_parts.at(v).size() > 1 && region_vertices.insert(v).second)
+                    {
+                        frontier.push_back(m.tuple_from_id(0, v));
+                    }
+                }
+            }
+            for (int k = 1; k < ghost_depth && !frontier.empty(); ++k)
+            {
+                std::vector<Tuple> next_frontier;
+                for (const Tuple &t : frontier)
+                {
+                    for (const Tuple &nt : vertex_one_ring(t, m))
+                    {
+                        if (region_vertices.insert(Simplex(0, nt).global_id()).second)
+                        {
+                            next_frontier.push_back(nt);
+                        }
+                    }
+                }
+                frontier = std::move(next_frontier);
+            }
+
+            std::vector<SimplexId> region;
+            for (const long &v : region_vertices)
+            {
+                region.emplace_back(0, v);
+            }
+            for (const Tuple &t : top_cofaces(SimplicialComplex::from_sorted(std::move(region)), m))
+            {
+                const long c = Simplex(cell_dim, t).global_id();
+                if (cell_part[c] != int(p))
+                {
+                    part.ghost_cells.push_back(c);
+                }
+            }
+            std::sort(part.ghost_cells.begin(), part.ghost_cells.end());
+
+            // local ids: simplices owned by this part first, then the ones it only reads
+            // every part already has its own thread, so the closure is built serially
+            std::vector<Tuple> cells;
+            for (const long &c : part.owned_cells)
+            {
+                cells.push_back(m.tuple_from_id(cell_dim, c));
+            }
+            for (const long &c : part.ghost_cells)
+            {
+                cells.push_back(m.tuple_from_id(cell_dim, c));
+            }
+            SimplicialComplexBuilder builder;
+            builder.add_simplices_with_boundary(cells, cell_dim, m);
+            const SimplicialComplex all = builder.finalize();
+
+            for (const bool is_owned_pass : {true, false})
+            {
+                for (const SimplexId &s : all.get_simplices())
+                {
+                    const int d = s.dimension();
+                    if ((owner[d][s.global_id()] == int(p)) != is_owned_pass)
+                    {
+                        continue;
+                    }
+                    part.global_to_local[d][s.global_id()] = part.local_to_global[d].size();
+                    part.local_to_global[d].push_back(s.global_id());
+                    if (is_owned_pass)
+                    {
+                        ++part.n_owned[d];
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    return parts;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+//////////////////////////////////
+// locality-improving reordering
+// reverse Cuthill-McKee on the dual graph: cells that are adjacent in the mesh get
+// nearby ids, so closed_star BFS, k_ring and sw() chains stay in cache
+//////////////////////////////////
+struct MeshReordering
+{
+    std::vector<long> vertex_new_to_old;
+    std::vector<long> vertex_old_to_new;
+    std::vector<long> cell_new_to_old;
+    std::vector<long> cell_old_to_new;
+
+    /**
+     * @brief map a vertex or cell of a query result on the reordered mesh back to its old id
+     */
+    long old_id(const SimplexId &s, const Mesh &m) const
+    {
+        if (s.dimension() == 0)
+        {
+            return vertex_new_to_old[s.global_id()];
+        }
+        assert(s.dimension() == m.cell_dimension());
+        return cell_new_to_old[s.global_id()];
+    }
+};
+
+/**
+ * @brief compute a reverse Cuthill-McKee order of the cells and a matching vertex order
+ *
+ * Vertices are numbered in order of first appearance in the new cell order. Only the
+ * connectivity is used, the mesh has no geometry to sort by.
+ */
+inline MeshReordering compute_reordering(const Mesh &m)
+{
+    const int &cell_dim = m.cell_dimension();
+    const long n_cells = m.simplex_count(cell_dim);
+    const long n_vertices = m.simplex_count(0);
+
+    // dual graph degree: number of interior facets
+    std::vector<int> degree(n_cells, 0);
+    parallel_for(n_cells, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            for (const Tuple &f : detail::cell_facets(m.tuple_from_id(cell_dim, c), m))
+            {
+                degree[c] += f.is_boundary(m) ? 0 : 1;
+            }
+        }
+    });
+
+    // seed every component with an unvisited cell of minimal degree
+    std::vector<long> seeds(n_cells);
+    for (long c = 0; c < n_cells; ++c)
+    {
+        seeds[c] = c;
+    }
+    std::stable_sort(seeds.begin(), seeds.end(), [&degree](const long &a, const long &b) { return degree[a] < degree[b]; });
+
+    MeshReordering r;
+    r.cell_new_to_old.reserve(n_cells);
+    std::vector<char> is_visited(n_cells, false);
+    std::vector<long> neighbors;
+    for (const long &seed : seeds)
+    {
+        if (is_visited[seed])
+        {
+            continue;
+        }
+        is_visited[seed] = true;
+        size_t head = r.cell_new_to_old.size();
+        r.cell_new_to_old.push_back(seed);
+        while (head < r.cell_new_to_old.size())
+        {
+            const long c = r.cell_new_to_old[head++];
+            neighbors.clear();
+            for (const Tuple &f : detail::cell_facets(m.tuple_from_id(cell_dim, c), m))
+            {
+                if (f.is_boundary(m))
+                {
+                    continue;
+                }
+                const long n = Simplex(cell_dim, f.sw(cell_dim, m)).global_id();
+                if (!is_visited[n])
+                {
+                    is_visited[n] = true;
+                    neighbors.push_back(n);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(), [&degree](const long &a, const long &b) { return degree[a] < degree[b]; });
+            r.cell_new_to_old.insert(r.cell_new_to_old.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(r.cell_new_to_old.begin(), r.cell_new_to_old.end());
+
+    r.cell_old_to_new.resize(n_cells);
+    for (long i = 0; i < n_cells; ++i)
+    {
+        r.cell_old_to_new[r.cell_new_to_old[i]] = i;
+    }
+
+    r.vertex_old_to_new.assign(n_vertices, -1);
+    r.vertex_new_to_old.reserve(n_vertices);
+    for (const long &c : r.cell_new_to_old)
+    {
+        for (const long &v : detail::cell_vertex_ids(c, m))
+        {
+            if (r.vertex_old_to_new[v] < 0)
+            {
+                r.vertex_old_to_new[v] = r.vertex_new_to_old.size();
+                r.vertex_new_to_old.push_back(v);
+            }
+        }
+    }
+    // isolated vertices keep their relative order at the end
+    for (long v = 0; v < n_vertices; ++v)
+    {
+        if (r.vertex_old_to_new[v] < 0)
+        {
+            r.vertex_old_to_new[v] = r.vertex_new_to_old.size();
+            r.vertex_new_to_old.push_back(v);
+        }
+    }
+
+    return r;
+}
+
+/**
+ * @brief reorder the vertices and cells of m in place
+ *
+ * @returns the permutation, to map query results back to the old ids
+ */
+inline MeshReordering reorder_mesh(Mesh &m)
+{
+    MeshReordering r = compute_reordering(m);
+    m.permute(r.vertex_new_to_old, r.cell_new_to_old);
+    return r;
+}
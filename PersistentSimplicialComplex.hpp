@@ -0,0 +1,221 @@
+#pragma once
+
+#include "SimplicialComplexV2.hpp"
+
+#include <memory>
+
+//////////////////////////////////
+// persistent simplicial complex
+// copies are O(1) snapshots; a modified complex shares all untouched chunks with its ancestors,
+// so speculative operations can keep the "before" state and roll back for free
+//////////////////////////////////
+class PersistentSimplicialComplex
+{
+public:
+    // a chunk is split once it grows beyond this
+    static constexpr size_t chunk_capacity = 256;
+
+private:
+    // sorted, non-empty, and every chunk's simplices are smaller than the next chunk's
+    using Chunk = std::vector<SimplexId>;
+    using ChunkList = std::vector<std::shared_ptr<const Chunk>>;
+
+    std::shared_ptr<const ChunkList> chunks = std::make_shared<const ChunkList>();
+    size_t n_simplices = 0;
+
+    /**
+     * @brief index of the chunk that holds s, or would hold it
+     */
+    size_t find_chunk(const SimplexId &s) const
+    {
+        const auto it = std::lower_bound(chunks->begin(), chunks->end(), s, [](const std::shared_ptr<const Chunk> &c, const SimplexId &v) {
+            return c->back() < v;
+        });
+        const size_t i = it - chunks->begin();
+        return std::min(i, chunks->size() - 1);
+    }
+
+public:
+    PersistentSimplicialComplex() = default;
+
+    explicit PersistentSimplicialComplex(const SimplicialComplex &sc)
+    {
+        auto list = std::make_shared<ChunkList>();
+        Chunk chunk;
+        for (const SimplexId &s : sc.get_simplices())
+        {
+            chunk.push_back(s);
+            if (chunk.size() == chunk_capacity / 2)
+            {
+                list->push_back(std::make_shared<const Chunk>(std::move(chunk)));
+                chunk = Chunk();
+            }
+        }
+        if (!chunk.empty())
+        {
+            list->push_back(std::make_shared<const Chunk>(std::move(chunk)));
+        }
+        chunks = std::move(list);
+        n_simplices = sc.get_simplices().size();
+    }
+
+    // copying is the O(1) snapshot
+    PersistentSimplicialComplex(const PersistentSimplicialComplex &) = default;
+    PersistentSimplicialComplex &operator=(const PersistentSimplicialComplex &) = default;
+
+    size_t get_size() const { return n_simplices; }
+
+    bool contains(const SimplexId &s) const
+    {
+        if (chunks->empty())
+        {
+            return false;
+        }
+        const Chunk &c = *(*chunks)[find_chunk(s)];
+        return std::binary_search(c.begin(), c.end(), s);
+    }
+
+    /**
+     * @brief Add simplex to the complex if it is not already in it.
+     *
+     * Copies the chunk list and the one modified chunk, O(chunk_capacity + size / chunk_capacity).
+     *
+     * @returns false if simplex is already in the complex
+     */
+    bool add_simplex(const SimplexId &s)
+    {
+        if (chunks->empty())
+        {
+            chunks = std::make_shared<const ChunkList>(ChunkList{std::make_shared<const Chunk>(Chunk{s})});
+            n_simplices = 1;
+            return true;
+        }
+
+        const size_t i = find_chunk(s);
+        const Chunk &old_chunk = *(*chunks)[i];
+        const auto pos = std::lower_bound(old_chunk.begin(), old_chunk.end(), s);
+        if (pos != old_chunk.end() && *pos == s)
+        {
+            return false;
+        }
+
+        Chunk chunk;
+        chunk.reserve(old_chunk.size() + 1);
+        chunk.insert(chunk.end(), old_chunk.begin(), pos);
+        chunk.push_back(s);
+        chunk.insert(chunk.end(), pos, old_chunk.end());
+
+        auto list = std::make_shared<ChunkList>(*chunks);
+        if (chunk.size() > chunk_capacity)
+        {
+            const auto mid = chunk.begin() + chunk.size() / 2;
+            (*list)[i] = std::make_shared<const Chunk>(chunk.begin(), mid);
+            list->insert(list->begin() + i + 1, std::make_shared<const Chunk>(mid, chunk.end()));
+        }
+        else
+        {
+            (*list)[i] = std::make_shared<const Chunk>(std::move(chunk));
+        }
+        chunks = std::move(list);
+        ++n_simplices;
+        return true;
+    }
+
+    bool add_simplex(const Simplex &s) { return add_simplex(SimplexId(s)); }
+
+    /**
+     * @returns false if simplex is not in the complex
+     */
+    bool remove_simplex(const SimplexId &s)
+    {
+        if (!contains(s))
+        {
+            return false;
+        }
+
+        const size_t i = find_chunk(s);
+        const Chunk &old_chunk = *(*chunks)[i];
+        auto list = std::make_shared<ChunkList>(*chunks);
+        if (old_chunk.size() == 1)
+        {
+            list->erase(list->begin() + i);
+        }
+        else
+        {
+            Chunk chunk = old_chunk;
+            chunk.erase(std::lower_bound(chunk.begin(), chunk.end(), s));
+            (*list)[i] = std::make_shared<const Chunk>(std::move(chunk));
+        }
+        chunks = std::move(list);
+        --n_simplices;
+        return true;
+    }
+
+    void unify_with_complex(const SimplicialComplex &other)
+    {
+        for (const SimplexId &s : other.get_simplices())
+        {
+            add_simplex(s);
+        }
+    }
+
+    /**
+     * @brief call f on every simplex, in sorted order
+     */
+    template <typename Func>
+    void for_each(Func &&f) const
+    {
+        for (const auto &c : *chunks)
+        {
+            for (const SimplexId &s : *c)
+            {
+                f(s);
+            }
+        }
+    }
+
+    SimplicialComplex to_complex() const
+    {
+        std::vector<SimplexId> sorted;
+        sorted.reserve(n_simplices);
+        for_each([&sorted](const SimplexId &s) { sorted.push_back(s); });
+        return SimplicialComplex::from_sorted(std::move(sorted));
+    }
+
+    /**
+     * @brief number of chunks stored once for both complexes
+     */
+    size_t n_shared_chunks(const PersistentSimplicialComplex &other) const
+    {
+        std::set<const Chunk *> mine;
+        for (const auto &c : *chunks)
+        {
+            mine.insert(c.get());
+        }
+        size_t ret = 0;
+        for (const auto &c : *other.chunks)
+        {
+            ret += mine.count(c.get());
+        }
+        return ret;
+    }
+
+    bool operator==(const PersistentSimplicialComplex &other) const
+    {
+        if (chunks == other.chunks)
+        {
+            return true; // same snapshot
+        }
+        if (n_simplices != other.n_simplices)
+        {
+            return false;
+        }
+        std::vector<SimplexId> mine;
+        mine.reserve(n_simplices);
+        for_each([&mine](const SimplexId &s) { mine.push_back(s); });
+        size_t i = 0;
+        bool is_equal = true;
+        other.for_each([&](const SimplexId &s) { is_equal = is_equal && mine[i++] == s; });
+        return is_equal;
+    }
+};
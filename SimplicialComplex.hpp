@@ -1,128 +1,61 @@
+#pragma once
 
+// Legacy types and operator names, implemented on top of SimplicialComplexV2.hpp.
 // note that this code only works for triangle/tet meshes
-// TODO: optimize it from n^2 to nlg(n)
-struct Simplex {
+
+#include "SimplicialComplexV2.hpp"
+
+/**
+ * @brief simplex with the legacy public members, converts to and from Simplex
+ */
+struct LegacySimplex
+{
     int d;
     Tuple t;
-    Simplex(int d, Tuple t) : d(d), t(t) {}
-};
 
-class SimplicialComplex
-{
-private:
-    std::vector<std::vector<Tuple>> simplexes;
-    const Mesh &m;
-public:
-    std::vector<std::vector<Tuple>> get_simplexes() const
-    {
-        return simplexes;
-    }
-    
-    int get_size() const
-    {
-        int ret = 0;
-        for (int d = 0; d < 4; d++)
-        {
-            ret += simplexes[d].size();
-        }
-        return ret;
-    }
+    LegacySimplex(const int &d_, const Tuple &t_) : d{d_}, t{t_} {}
 
-    bool AddSimplex(Simplex s)
-    {
-        assert(s.d < 4);
-        for (auto tmp : simplexes[s.d])
-        {
-            // TODO: need implement is_same_simplex for tuples
-            // is_same_simplex(t1, t2, dim, m) returns if (dim, t1) and (dim, t2) are the same simplex in Mesh m
-            // Need it in Mesh class
-            if (is_same_simplex(tmp, s.t, s.d, m))
-            {
-                return false;
-            }
-        }
-        simplexes[s.d].push_back(s.t);
-        return true;
-    }
-    
-    void unionComplex(const SimplicialComplex &other)
-    {
-        for (int d = 0; d < 4; d++)
-        {
-            for (auto t : other.simplexes[d])
-            {
-                AddSimplex(Simplex(d, t));
-            }
-        }
-    }
+    LegacySimplex(const Simplex &s) : d{s.dimension()}, t{s.tuple()} {}
 
-    bool operator==(const SimplicialComplex& other) const
-    {
-        for (int d = 0; d <= 4; d++)
-        {
-            if (simplexes[d].size() != other.simplexes[d].size())
-            {
-                return false;
-            }   
-            for (auto t1 : simplexes[d])
-            {
-                bool flag = false;
-                for (auto t2 : other.simplexes[d])
-                {
-                    if (is_same_simplex(t1, t2, d, m))
-                    {
-                        flag = true;
-                        break;
-                    }
-                }
-                if (!flag) return false;
-            }
-        }
-        return true;
-    }
-
-    SimplicialComplex& operator=(const SimplicialComplex& other) 
-    {
-        if (this != &other) 
-        {
-            this->simplexes = other.simplexes;
-        }
-        return *this;
-    }
-    
-    SimplicialComplex(const Mesh& m);
-    ~SimplicialComplex();
+    operator Simplex() const { return Simplex(d, t); }
 };
 
-SimplicialComplex::SimplicialComplex(const Mesh& m)
+/**
+ * @brief complex with the legacy member names
+ *
+ * Remembers the mesh it was built on, so get_simplexes() can recover tuples from the stored ids.
+ */
+class LegacySimplicialComplex : public SimplicialComplex
 {
-    this->m = m;
-    simplexes.resize(4);
-}
+private:
+    const Mesh *m;
 
-SimplicialComplex::~SimplicialComplex()
-{
-}
+public:
+    explicit LegacySimplicialComplex(const Mesh &mesh) : m{&mesh} {}
 
+    LegacySimplicialComplex(const SimplicialComplex &sc, const Mesh &mesh) : SimplicialComplex(sc), m{&mesh} {}
 
-SimplicialComplex SC_intersect(const SimplicialComplex &A, const SimplicialComplex &B, const Mesh &m)
-{
-    SimplicialComplex SC_union = A;
-    SimplicialComplex SC_intersect(m);
-    auto s_B = B.get_simplexes();
+    bool AddSimplex(const Simplex &s) { return add_simplex(s); }
+
+    void unionComplex(const SimplicialComplex &other) { unify_with_complex(other); }
 
-    for (int d = 0; d < 4; d++)
+    /**
+     * @brief tuples of the complex grouped by dimension
+     */
+    std::vector<std::vector<Tuple>> get_simplexes() const
     {
-        for (auto t : s_B)
+        std::vector<std::vector<Tuple>> ret(4);
+        for (const SimplexId &s : get_simplices())
         {
-            if (!SC_union.AddSimplex(Simplex(d, t)))
-            {
-                SC_intersect.AddSimplex(Simplex(d, t));
-            }
+            ret[s.dimension()].push_back(s.simplex(*m).tuple());
         }
+        return ret;
     }
+};
 
-    return SC_intersect;
+inline LegacySimplicialComplex SC_intersect(const SimplicialComplex &A, const SimplicialComplex &B, const Mesh &m)
+{
+    return LegacySimplicialComplex(get_intersection(A, B), m);
 }
 
 //////////////////////////////////
@@ -135,300 +68,43 @@ SimplicialComplex SC_intersect(const SimplicialComplex &A, const SimplicialCompl
 //////////////////////////////////
 
 // ∂s
-SimplicialComplex bd(const Simplex &s, const Mesh& m)
+inline LegacySimplicialComplex bd(const Simplex &s, const Mesh &m)
 {
-    SimplicialComplex SC(m);
-
-    // exhaustive implementation
-    switch (s.d)
-    {
-    case 3: // bd(tet) = 4triangles + 6 edges + 4vertices
-        SC.AddSimplex(Simplex(0, s.t));                                         // A
-        SC.AddSimplex(Simplex(0, s.t.sw(0, m)));                                // B
-        SC.AddSimplex(Simplex(0, s.t.sw(1, m).sw(0, m)));                       // C
-        SC.AddSimplex(Simplex(0, s.t.sw(2, m).sw(0, m)));                       // D
-        SC.AddSimplex(Simplex(1, s.t));                                         // AB
-        SC.AddSimplex(Simplex(1, s.t.sw(1, m)));                                // AC
-        SC.AddSimplex(Simplex(1, s.t.sw(0, m).sw(1, m)));                       // BC
-        SC.AddSimplex(Simplex(1, s.t.sw(2, m).sw(1, m)));                       // AD
-        SC.AddSimplex(Simplex(1, s.t.sw(0, m).sw(2, m).sw(1, m)));              // BD 
-        SC.AddSimplex(Simplex(1, s.t.sw(1, m).sw(0, m).sw(2, m).sw(1, m)));     // CD
-        SC.AddSimplex(Simplex(2, s.t));                                         // ABC
-        SC.AddSimplex(Simplex(2, s.t.sw(2, m)));                                // ABD
-        SC.AddSimplex(Simplex(2, s.t.sw(1, m).sw(2, m)));                       // ACD
-        SC.AddSimplex(Simplex(2, s.t.sw(0, m).sw(1, m).sw(2, m)));              // BCD
-        break;
-    case 2: // bd(triangle) = 3edges + 3vertices
-        SC.AddSimplex(Simplex(0, s.t));
-        SC.AddSimplex(Simplex(0, s.t.sw(0, m)));
-        SC.AddSimplex(Simplex(0, s.t.sw(1, m).sw(0, m)));
-        SC.AddSimplex(Simplex(1, s.t));
-        SC.AddSimplex(Simplex(1, s.t.sw(1, m)));
-        SC.AddSimplex(Simplex(1, s.t.sw(0, m).sw(1, m)));
-        /* code */
-        break;
-    case 1:
-        // bd(edge) = 2 vertices
-        SC.AddSimplex(Simplex(0, s.t));
-        SC.AddSimplex(Simplex(0, s.t.sw(0, m)));
-        /* code */
-        break;
-    case 0:
-        break;        
-    default:
-        assert(false);
-        break;
-    }
-
-    return SC;
+    return LegacySimplicialComplex(boundary(s, m), m);
 }
 
 // ∂s∪{s}
-SimplicialComplex clbd(const Simplex &s, const Mesh& m)
+inline LegacySimplicialComplex clbd(const Simplex &s, const Mesh &m)
 {
-    SimplicialComplex SC = bd(s, m);
-    SC.AddSimplex(s);
-    return SC;
+    return LegacySimplicialComplex(simplex_with_boundary(s, m), m);
 }
 
 // Simplex s1,s2, check if A∩B!=∅
-// check is intersect(∂s1, ∂s2) has intersections
-bool is_intersect(Simplex s1, Simplex s2, Mesh &m)
+inline bool is_intersect(const Simplex &s1, const Simplex &s2, const Mesh &m)
 {
-    SimplicialComplex s1_bd = clbd(s1);
-    SimplicialComplex s2_bd = clbd(s2);
-    SimplicialComplex s1_s2_int = SC_intersect(s1_bd, s2_bd, m);
-    return (s1_s2_int.get_size() != 0);
+    return simplices_w_boundary_intersect(s1, s2, m);
 }
 
-SimplicialComplex clst(const Simplex &s, const Mesh& m)
+inline LegacySimplicialComplex clst(const Simplex &s, const Mesh &m)
 {
-    SimplicialComplex SC(m);
-    int dim = m.dim; // TODO: 2 for trimesh, 3 for tetmesh need it in Mesh class
-
-    if (dim == 2)
-    {
-        switch (s.d)
-        {
-        case 0:
-            std::queue<Tuple> q;
-            q.push(s.t);
-            while (!q.empty())
-            {
-                auto t = q.front();
-                q.pop();
-                if (SC.AddSimplex(Simplex(2, t)))
-                {
-                    if (!t.boundary(m))
-                    {
-                        q.push(t.sw(2, m));
-                    }
-                    if (!t.sw(1, m).boundary(m))
-                    {
-                        q.push(t.sw(1, m).sw(2, m));
-                    }
-                }
-            }
-            break;
-        case 1:
-            SC.addSimplex(Simplex(2, s.t));
-            if (!s.t.boundary(m))
-            {
-                SC.addSimplex(Simplex(2, s.t.sw(2, m)));
-            }
-            break;
-        case 2:
-            SC.addSimplex(s);
-            break;
-        default:
-            assert(false);
-            break;
-        }
-        
-    }
-    else if (dim == 3)
-    {
-        switch (s.d)
-        {
-        case 0:
-            std::queue<Tuple> q;
-            q.push(s.t);
-            while (!q.empty())
-            {
-                auto t = q.front();
-                q.pop();
-                if (SC.AddSimplex(Simplex(3, t)))
-                {
-                    if (!t.boundary(m))
-                    {
-                        q.push(t.sw(3, m));
-                    }
-                    if (!t.sw(2, m).boundary(m))
-                    {
-                        q.push(t.sw(2, m).sw(3, m));
-                    }
-                    if (!t.sw(1, m).sw(2, m).boundary(m))
-                    {
-                        q.push(t.sw(1, m).sw(2, m).sw(3, m));
-                    }
-                }
-            }
-            break;
-        case 1:
-            std::queue<Tuple> q;
-            q.push(s.t);
-            while (!q.empty())
-            {
-                auto t = q.front();
-                q.pop();
-                if (SC.AddSimplex(Simplex(3, t)))
-                {
-                    if (!t.boundary(m))
-                    {
-                        q.push(t.sw(3, m));
-                    }
-                    if (!t.sw(2, m).boundary(m))
-                    {
-                        q.push(t.sw(2, m).sw(3, m));
-                    }
-                }
-            }
-            break;
-        case 2:
-            SC.addSimplex(Simplex(3, s.t));
-            if (!s.t.boundary(m))
-            {
-                SC.addSimplex(Simplex(3, s.t.sw(3, m)));
-            }
-            break;
-        case 3:
-            SC.addSimplex(s);
-            break;
-        default:
-            assert(false);
-            break;
-        }  
-    }
-
-    auto top_tuples = SC.get_simplexes()[dim];
-    for (Tuple t : top_tuples)
-    {
-      SC.unionComplex(bd(Simplex(dim, t),m));
-    }
-    return SC;
+    return LegacySimplicialComplex(closed_star(s, m), m);
 }
 
-SimplicialComplex lnk(const Simplex &s, const Mesh& m)
+inline LegacySimplicialComplex lnk(const Simplex &s, const Mesh &m)
 {
-    SimplicialComplex SC_clst = clst(s, m);
-    SimplicialComplex SC(m);
-    auto simplexes = SC_clst.get_simplexes();
-    for (int d = 0; d < 4; d++)
-    {
-        for (auto t : simplexes[d])
-        {
-            if (!is_intersect(s, Simplex(d, t)))
-            {
-                SC.addSimplex(Simplex(d, t));
-            }
-        }
-    }
-    return SC;
+    return LegacySimplicialComplex(link(s, m), m);
 }
 
-SimplicialComplex st(const Simplex &s, const Mesh& m)
+inline LegacySimplicialComplex st(const Simplex &s, const Mesh &m)
 {
-    SimplicialComplex SC_clst = clst(s, m);
-    SimplicialComplex SC;
-    SC.addSimplex(s);
-    auto simplexes = SC_clst.get_simplexes();
-    for (int d = s.d + 1; d < 4; d++)
-    {
-        for (auto t : simplexes[d])
-        {
-            if (is_intersect(s, Simplex(d, t)))
-            {
-                SC.addSimplex(Simplex(d, t));
-            }
-        }
-    }
-    return SC;
+    return LegacySimplicialComplex(open_star(s, m), m);
 }
 
-
-//////////////////////////////////
-// check link condition
-// input Tuple t --> edge (a,b)
-// check if lnk(a) ∩ lnk(b) == lnk(ab)
-//////////////////////////////////
-bool link_cond(Tuple t, const Mesh& m)
-{
-    SimplicialComplex lhs = lnk(Simplex(t, 0), m); // lnk(a)
-    lhs.unionComplex(lnk(Simplex(t.sw(0, m), 0), m)); // Union lnk(b)
-
-    SimplicialComplex rhs = lnk(Simplex(t, 1), m); // lnk(ab)
-    return (lhs == rhs);
-}
-
-
 //////////////////////////////////
 // k-ring
+// link_cond and k_ring keep their names in SimplicialComplexV2.hpp
 //////////////////////////////////
-std::vector<Tuple> one_ring(Tuple t, const Mesh& m)
+inline std::vector<Tuple> one_ring(Tuple t, const Mesh &m)
 {
-    Simplex s(0, t);
-    SimplicialComplex s_st = st(s, m);
-    std::vector<Tuple> Vs = s_st.get_simplexes()[1];
-    for (int i = 0; i < Vs.size(); i++)
-    {
-        if (is_same_simplex(t, Vs[i], 0, m))
-        {
-            Vs[i] = Vs[i].sw(0, m);
-        }
-    }
-    return Vs;
+    return vertex_one_ring(t, m);
 }
-
-std::vector<Tuple> k_ring(Tuple t, const Mesh& m, int k)
-{
-    assert(k >= 1);
-
-    if (k == 1)
-    {
-        return one_ring(t, m);
-    }
-    else
-    {
-        std::vector<Tuple> t_one_ring = one_ring(t, m);
-        std::vector<std::vector<Tuple>> all_ts;
-        for (auto tmp : t_one_ring)
-        {
-            all_ts.push_back(k_ring(tmp, m, k - 1));
-        }
-
-        std::vector<Tuple> ret;
-        for (auto t_vec : all_ts)
-        {
-            for (auto tmp : t_vec)
-            {
-                bool flag = true;
-                for (int i = 0; i < ret.size(); i++)
-                {
-                    if (is_same_simplex(ret[i], tmp, 0, m))
-                    {
-                        flag = false;
-                        break;
-                    }
-                    if (flag)
-                    {
-                        ret.push_back(tmp);
-                    }
-                }
-            }
-        }
-    
-        return ret;
-    }
-}
-
-
@@ -1,7 +1,14 @@
+#pragma once
+
 #include <vector>
 #include <set>
 #include <cassert>
 #include <queue>
+#include <thread>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
 
 struct Tuple;
 
@@ -12,17 +19,61 @@ struct Mesh
         throw std::exception("This is a dummy implementation!");
         return {};
     }
+
+    // switch all n tuples in place, see sw_chain()
+    void sw_batch(Tuple *tuples, const size_t &n, const int &d) const;
+
     bool is_boundary(const Tuple &t, const int &d) const
     {
         throw std::exception("This is a dummy implementation!");
         return false;
     }
 
+    // whether the vertex order of t (a, b, c, d) is the orientation of its cell, every sw() flips it
+    bool is_ccw(const Tuple &t) const
+    {
+        throw std::exception("This is a dummy implementation!");
+        return true;
+    }
+
     int cell_dimension() const
     {
         throw std::exception("This is a dummy implementation!");
         return 3;
     }
+
+    bool is_valid(const Tuple &t) const
+    {
+        throw std::exception("This is a dummy implementation!");
+        return false;
+    }
+
+    // number of simplices of dimension d, global ids are in [0, simplex_count(d))
+    long simplex_count(const int &d) const
+    {
+        throw std::exception("This is a dummy implementation!");
+        return 0;
+    }
+
+    // any tuple pointing to the simplex of dimension d with the given global id
+    Tuple tuple_from_id(const int &d, const long &gid) const
+    {
+        throw std::exception("This is a dummy implementation!");
+        return {};
+    }
+
+    // renumber vertices and cells, new id i gets the old id *_new_to_old[i]; edges and faces are rebuilt from the cells
+    void permute(const std::vector<long> &vertex_new_to_old, const std::vector<long> &cell_new_to_old)
+    {
+        throw std::exception("This is a dummy implementation!");
+    }
+
+    // collapse the edge of t, returns a tuple pointing to the merged vertex
+    Tuple collapse_edge(const Tuple &t)
+    {
+        throw std::exception("This is a dummy implementation!");
+        return {};
+    }
 };
 
 struct Tuple
@@ -40,6 +91,29 @@ struct Tuple
     }
 };
 
+// scalar fallback; a mesh with flat adjacency arrays gathers the n neighbors here, e.g. with SIMD gathers
+inline void Mesh::sw_batch(Tuple *tuples, const size_t &n, const int &d) const
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        tuples[i] = sw(tuples[i], d);
+    }
+}
+
+/**
+ * @brief apply the same switch sequence to every tuple, tuples[i] = tuples[i].sw(chain[0], m).sw(chain[1], m)...
+ *
+ * The tuples are switched in lockstep, one switch of the chain for all tuples at a time, so the
+ * loads of independent tuples do not wait on each other.
+ */
+inline void sw_chain(std::vector<Tuple> &tuples, const std::vector<int> &chain, const Mesh &m)
+{
+    for (const int &d : chain)
+    {
+        m.sw_batch(tuples.data(), tuples.size(), d);
+    }
+}
+
 // note that this code only works for triangle/tet meshes
 class Simplex
 {
@@ -72,158 +146,207 @@ public:
     }
 };
 
+/**
+ * @brief packed 64-bit simplex handle, the dimension is in the top bits and the global id below
+ *
+ * Comparison only needs (dimension, global id), so complexes store these instead of Simplex.
+ * Use simplex(m) to get a Tuple back when navigation is needed.
+ */
+class SimplexId
+{
+    static constexpr int dim_shift = 61;
+    static constexpr uint64_t id_mask = (uint64_t(1) << dim_shift) - 1;
+
+    uint64_t _v = 0;
+
+public:
+    SimplexId() = default;
+    SimplexId(const int &d, const long &gid) : _v{(uint64_t(d) << dim_shift) | (uint64_t(gid) & id_mask)} {}
+    explicit SimplexId(const Simplex &s) : SimplexId(s.dimension(), s.global_id()) {}
+
+    int dimension() const { return int(_v >> dim_shift); }
+    long global_id() const { return long(_v & id_mask); }
+    uint64_t value() const { return _v; }
+
+    Simplex simplex(const Mesh &m) const
+    {
+        return Simplex(dimension(), m.tuple_from_id(dimension(), global_id()));
+    }
+
+    // same order as Simplex: by dimension, then by global id
+    bool operator<(const SimplexId &rhs) const { return _v < rhs._v; }
+    bool operator==(const SimplexId &rhs) const { return _v == rhs._v; }
+    bool operator!=(const SimplexId &rhs) const { return _v != rhs._v; }
+};
+
 class SimplicialComplex
 {
 private:
-    std::set<Simplex> simplexes;
+    std::vector<SimplexId> simplexes; // sorted and duplicate-free, i.e. by dimension, then by global id
 
 public:
-    const std::set<Simplex> &get_simplices() const
+    const std::vector<SimplexId> &get_simplices() const
     {
         return simplexes;
     }
 
-    std::set<Simplex> get_simplices(const int &dim) const
+    std::vector<SimplexId> get_simplices(const int &dim) const
     {
-        std::set<Simplex> ret;
-        for (const Simplex &s : simplexes)
-        {
-            if (s.dimension() == dim)
-            {
-                ret.insert(s);
-            }
-        }
+        // simplices are sorted by dimension
+        const auto begin = std::lower_bound(simplexes.begin(), simplexes.end(), SimplexId(dim, 0));
+        const auto end = std::lower_bound(begin, simplexes.end(), SimplexId(dim + 1, 0));
+        return std::vector<SimplexId>(begin, end);
+    }
 
-        return ret;
+    /**
+     * @brief number of simplices of dimension dim, without copying them
+     */
+    size_t get_simplex_count(const int &dim) const
+    {
+        const auto begin = std::lower_bound(simplexes.begin(), simplexes.end(), SimplexId(dim, 0));
+        const auto end = std::lower_bound(begin, simplexes.end(), SimplexId(dim + 1, 0));
+        return std::distance(begin, end);
     }
 
     /**
      * @brief Add simplex to the complex if it is not already in it.
      *
+     * Shifts all larger simplices, use SimplicialComplexBuilder to add many simplices.
+     *
      * @returns false if simplex is already in the complex
      */
-    bool add_simplex(const Simplex &s)
+    bool add_simplex(const SimplexId &s)
     {
         assert(s.dimension() <= 4);
-        const auto [it, was_successful] = simplexes.insert(s);
-        return was_successful;
+        const auto it = std::lower_bound(simplexes.begin(), simplexes.end(), s);
+        if (it != simplexes.end() && *it == s)
+        {
+            return false;
+        }
+        simplexes.insert(it, s);
+        return true;
+    }
+
+    bool add_simplex(const Simplex &s)
+    {
+        return add_simplex(SimplexId(s));
+    }
+
+    bool contains(const SimplexId &s) const
+    {
+        return std::binary_search(simplexes.begin(), simplexes.end(), s);
     }
 
     void unify_with_complex(const SimplicialComplex &other)
     {
-        // this is N log(N) complexity
-        for (const Simplex &s : other.get_simplices())
-        {
-            add_simplex(s);
-        }
+        // both are sorted, this is linear
+        std::vector<SimplexId> u;
+        u.reserve(simplexes.size() + other.simplexes.size());
+        std::set_union(simplexes.begin(), simplexes.end(), other.simplexes.begin(), other.simplexes.end(), std::back_inserter(u));
+        simplexes = std::move(u);
     }
 
     bool operator==(const SimplicialComplex &other) const
     {
-        if (simplexes.size() != other.simplexes.size())
-        {
-            return false;
-        }
-        // this is N log(N) complexity
-        for (const auto &t1 : simplexes)
-        {
-            const auto it = other.simplexes.find(t1);
-            if (it == other.simplexes.end())
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return simplexes == other.simplexes;
     }
 
     SimplicialComplex &operator=(const SimplicialComplex &) = default;
 
     SimplicialComplex() = default;
 
+    /**
+     * @brief build a complex from sorted, duplicate-free simplices, without copying when moved in
+     */
+    static SimplicialComplex from_sorted(std::vector<SimplexId> sorted)
+    {
+        assert(std::is_sorted(sorted.begin(), sorted.end()));
+        assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        SimplicialComplex sc;
+        sc.simplexes = std::move(sorted);
+        return sc;
+    }
+
     SimplicialComplex(const std::vector<Tuple> &tv, const int dim)
     {
+        simplexes.reserve(tv.size());
         for (const Tuple &t : tv)
         {
-            add_simplex(Simplex(dim, t));
+            simplexes.emplace_back(Simplex(dim, t));
         }
+        std::sort(simplexes.begin(), simplexes.end());
+        simplexes.erase(std::unique(simplexes.begin(), simplexes.end()), simplexes.end());
     }
+
+    int get_size() const { return simplexes.size(); }
 };
 
 inline SimplicialComplex get_union(const SimplicialComplex &sc1, const SimplicialComplex &sc2)
 {
-    SimplicialComplex u = sc1;
-    u.unify_with_complex(sc2);
-    return u;
+    // both sets are sorted, this is linear
+    std::vector<SimplexId> u;
+    u.reserve(sc1.get_simplices().size() + sc2.get_simplices().size());
+    std::set_union(
+        sc1.get_simplices().begin(), sc1.get_simplices().end(),
+        sc2.get_simplices().begin(), sc2.get_simplices().end(),
+        std::back_inserter(u));
+    return SimplicialComplex::from_sorted(std::move(u));
 }
 
 inline SimplicialComplex get_intersection(const SimplicialComplex &A, const SimplicialComplex &B)
 {
-    SimplicialComplex sc_union = A;
-    SimplicialComplex sc_intersection;
-
-    for (const auto &s : B.get_simplices())
-    {
-        if (!sc_union.add_simplex(s))
-        {
-            // s is already in A --> s is in the intersection of A and B
-            sc_intersection.add_simplex(s);
-        }
-    }
-
-    return sc_intersection;
+    // both sets are sorted, this is linear
+    std::vector<SimplexId> intersection;
+    std::set_intersection(
+        A.get_simplices().begin(), A.get_simplices().end(),
+        B.get_simplices().begin(), B.get_simplices().end(),
+        std::back_inserter(intersection));
+    return SimplicialComplex::from_sorted(std::move(intersection));
 }
 
 //////////////////////////////////
-// List of Operators
-// bd: boundary
-// clbd: closed boudnary
-// st: start
-// clst: closed star
-// lnk: link
+// bulk building
 //////////////////////////////////
-
-// ∂s
 /**
- * @brief get the boundary of a simplex
+ * @brief append s and all its faces to _out_, without any duplicate check
+ *
+ * SimplexT is Simplex when the faces are navigated further, SimplexId otherwise.
  */
-SimplicialComplex boundary(const Simplex &s, const Mesh &m)
+template <typename SimplexT>
+void append_simplex_with_boundary(const Simplex &s, const Mesh &m, std::vector<SimplexT> &out)
 {
-    SimplicialComplex sc;
+    const Tuple &t = s.tuple();
+    out.emplace_back(s);
 
-    // exhaustive implementation
     switch (s.dimension())
     {
-    case 3:                                                                        // bd(tet) = 4triangles + 6 edges + 4vertices
-        sc.add_simplex(Simplex(0, s.tuple()));                                     // A
-        sc.add_simplex(Simplex(0, s.tuple().sw(0, m)));                            // B
-        sc.add_simplex(Simplex(0, s.tuple().sw(1, m).sw(0, m)));                   // C
-        sc.add_simplex(Simplex(0, s.tuple().sw(2, m).sw(0, m)));                   // D
-        sc.add_simplex(Simplex(1, s.tuple()));                                     // AB
-        sc.add_simplex(Simplex(1, s.tuple().sw(1, m)));                            // AC
-        sc.add_simplex(Simplex(1, s.tuple().sw(0, m).sw(1, m)));                   // BC
-        sc.add_simplex(Simplex(1, s.tuple().sw(2, m).sw(1, m)));                   // AD
-        sc.add_simplex(Simplex(1, s.tuple().sw(0, m).sw(2, m).sw(1, m)));          // BD
-        sc.add_simplex(Simplex(1, s.tuple().sw(1, m).sw(0, m).sw(2, m).sw(1, m))); // CD
-        sc.add_simplex(Simplex(2, s.tuple()));                                     // ABC
-        sc.add_simplex(Simplex(2, s.tuple().sw(2, m)));                            // ABD
-        sc.add_simplex(Simplex(2, s.tuple().sw(1, m).sw(2, m)));                   // ACD
-        sc.add_simplex(Simplex(2, s.tuple().sw(0, m).sw(1, m).sw(2, m)));          // BCD
+    case 3:
+        out.emplace_back(Simplex(0, t));                                     // A
+        out.emplace_back(Simplex(0, t.sw(0, m)));                            // B
+        out.emplace_back(Simplex(0, t.sw(1, m).sw(0, m)));                   // C
+        out.emplace_back(Simplex(0, t.sw(2, m).sw(1, m).sw(0, m)));          // D
+        out.emplace_back(Simplex(1, t));                                     // AB
+        out.emplace_back(Simplex(1, t.sw(1, m)));                            // AC
+        out.emplace_back(Simplex(1, t.sw(0, m).sw(1, m)));                   // BC
+        out.emplace_back(Simplex(1, t.sw(2, m).sw(1, m)));                   // AD
+        out.emplace_back(Simplex(1, t.sw(0, m).sw(2, m).sw(1, m)));          // BD
+        out.emplace_back(Simplex(1, t.sw(1, m).sw(0, m).sw(2, m).sw(1, m))); // CD
+        out.emplace_back(Simplex(2, t));                                     // ABC
+        out.emplace_back(Simplex(2, t.sw(2, m)));                            // ABD
+        out.emplace_back(Simplex(2, t.sw(1, m).sw(2, m)));                   // ACD
+        out.emplace_back(Simplex(2, t.sw(0, m).sw(1, m).sw(2, m)));          // BCD
         break;
-    case 2: // bd(triangle) = 3edges + 3vertices
-        sc.add_simplex(Simplex(0, s.tuple()));
-        sc.add_simplex(Simplex(0, s.tuple().sw(0, m)));
-        sc.add_simplex(Simplex(0, s.tuple().sw(1, m).sw(0, m)));
-        sc.add_simplex(Simplex(1, s.tuple()));
-        sc.add_simplex(Simplex(1, s.tuple().sw(1, m)));
-        sc.add_simplex(Simplex(1, s.tuple().sw(0, m).sw(1, m)));
-        /* code */
+    case 2:
+        out.emplace_back(Simplex(0, t));
+        out.emplace_back(Simplex(0, t.sw(0, m)));
+        out.emplace_back(Simplex(0, t.sw(1, m).sw(0, m)));
+        out.emplace_back(Simplex(1, t));
+        out.emplace_back(Simplex(1, t.sw(1, m)));
+        out.emplace_back(Simplex(1, t.sw(0, m).sw(1, m)));
         break;
     case 1:
-        // bd(edge) = 2 vertices
-        sc.add_simplex(Simplex(0, s.tuple()));
-        sc.add_simplex(Simplex(0, s.tuple().sw(0, m)));
-        /* code */
+        out.emplace_back(Simplex(0, t));
+        out.emplace_back(Simplex(0, t.sw(0, m)));
         break;
     case 0:
         break;
@@ -231,244 +354,1135 @@ SimplicialComplex boundary(const Simplex &s, const Mesh &m)
         assert(false);
         break;
     }
-
-    return sc;
 }
 
-// ∂s∪{s}
+namespace detail
+{
+    // a face of a simplex, reached from the simplex's tuple by the switch sequence _chain_
+    struct FaceChain
+    {
+        int dim;
+        std::vector<int> chain;
+    };
+
+    /**
+     * @brief faces of a simplex of dimension d, in the same order as append_simplex_with_boundary()
+     */
+    inline const std::vector<FaceChain> &face_chains(const int &d)
+    {
+        static const std::array<std::vector<FaceChain>, 4> chains = {
+            std::vector<FaceChain>{},
+            std::vector<FaceChain>{{0, {}}, {0, {0}}},
+            std::vector<FaceChain>{{0, {}}, {0, {0}}, {0, {1, 0}}, {1, {}}, {1, {1}}, {1, {0, 1}}},
+            std::vector<FaceChain>{
+                {0, {}}, {0, {0}}, {0, {1, 0}}, {0, {2, 1, 0}},                                  // A, B, C, D
+                {1, {}}, {1, {1}}, {1, {0, 1}}, {1, {2, 1}}, {1, {0, 2, 1}}, {1, {1, 0, 2, 1}}, // AB, AC, BC, AD, BD, CD
+                {2, {}}, {2, {2}}, {2, {1, 2}}, {2, {0, 1, 2}}}};                                // ABC, ABD, ACD, BCD
+        assert(d >= 0 && d < 4);
+        return chains[d];
+    }
+} // namespace detail
+
 /**
- * @brief get complex of a simplex and its boundary
+ * @brief append the faces of all d-simplices pointed to by _tuples_ to _out_, without any duplicate check
+ *
+ * Same faces as append_simplex_with_boundary(), but every face chain is navigated for all
+ * simplices in lockstep with sw_chain(). The output is grouped by face, not by simplex.
  */
-SimplicialComplex simplex_with_boundary(const Simplex &s, const Mesh &m)
+inline void append_boundary_batch(const std::vector<Tuple> &tuples, const int &d, const Mesh &m, std::vector<SimplexId> &out)
 {
-    SimplicialComplex sc = boundary(s, m);
-    sc.add_simplex(s);
-    return sc;
+    std::vector<Tuple> faces;
+    for (const detail::FaceChain &f : detail::face_chains(d))
+    {
+        faces = tuples;
+        sw_chain(faces, f.chain, m);
+        for (const Tuple &t : faces)
+        {
+            out.emplace_back(Simplex(f.dim, t));
+        }
+    }
 }
 
-// Simplex s1,s2, check if A∩B!=∅
-// check is intersect(∂s1, ∂s2) has intersections
 /**
- * @brief check if simplices with their boundary intersect
+ * @brief collect simplices without duplicate checks and build the complex once
+ *
+ * Appending is O(1); finalize() deduplicates with a single sort + unique and builds the
+ * complex in linear time from the sorted result.
  */
-inline bool simplices_w_boundary_intersect(const Simplex &s1, const Simplex &s2, const Mesh &m)
+class SimplicialComplexBuilder
 {
-    SimplicialComplex s1_bd = simplex_with_boundary(s1, m);
-    SimplicialComplex s2_bd = simplex_with_boundary(s2, m);
-    SimplicialComplex s1_s2_int = get_intersection(s1_bd, s2_bd);
-    return (s1_s2_int.get_simplices().size() != 0);
-}
+private:
+    std::vector<SimplexId> buffer;
 
-SimplicialComplex closed_star(const Simplex &s, const Mesh &m)
-{
-    SimplicialComplex sc;
-    const int &cell_dim = m->cell_dimension(); // TODO: 2 for trimesh, 3 for tetmesh need it in Mesh class
+public:
+    void reserve(const size_t &n) { buffer.reserve(n); }
 
-    if (cell_dim == 2)
+    void add_simplex(const SimplexId &s) { buffer.push_back(s); }
+
+    void add_simplex(const Simplex &s) { buffer.emplace_back(s); }
+
+    // ∂s∪{s}
+    void add_simplex_with_boundary(const Simplex &s, const Mesh &m)
     {
-        switch (s.dimension())
-        {
-        case 0:
-        {
-            std::queue<Tuple> q;
-            q.push(s.tuple());
-            while (!q.empty())
-            {
-                const Tuple t = q.front();
-                q.pop();
-                if (sc.add_simplex(Simplex(2, t)))
-                {
-                    if (!t.is_boundary(m))
-                    {
-                        q.push(t.sw(2, m));
-                    }
-                    if (!t.sw(1, m).is_boundary(m))
-                    {
-                        q.push(t.sw(1, m).sw(2, m));
-                    }
-                }
-            }
-            break;
-        }
-        case 1:
-            sc.add_simplex(Simplex(2, s.tuple()));
-            if (!s.tuple().is_boundary(m))
-            {
-                sc.add_simplex(Simplex(2, s.tuple().sw(2, m)));
-            }
-            break;
-        case 2:
-            sc.add_simplex(s);
-            break;
-        default:
-            assert(false);
-            break;
-        }
+        append_simplex_with_boundary(s, m, buffer);
     }
-    else if (cell_dim == 3)
+
+    // ∂s
+    void add_boundary(const Simplex &s, const Mesh &m)
     {
-        switch (s.dimension())
-        {
-        case 0:
-        {
-            std::queue<Tuple> q;
-            q.push(s.tuple());
-            while (!q.empty())
-            {
-                Tuple t = q.front();
-                q.pop();
-                if (sc.add_simplex(Simplex(3, t)))
-                {
-                    const Tuple t1 = t;
-                    const Tuple t2 = t.sw(2, m);
-                    const Tuple t3 = t.sw(1, m).sw(2, m);
-                    if (!t1.is_boundary(m))
-                    {
-                        q.push(t1.sw(3, m));
-                    }
-                    if (!t2.is_boundary(m))
-                    {
-                        q.push(t2.sw(3, m));
-                    }
-                    if (!t3.is_boundary(m))
-                    {
-                        q.push(t3.sw(3, m));
-                    }
-                }
-            }
-            break;
-        }
-        case 1:
-        {
-            std::queue<Tuple> q;
-            q.push(s.tuple());
-            while (!q.empty())
-            {
-                Tuple t = q.front();
-                q.pop();
-                if (sc.add_simplex(Simplex(3, t)))
-                {
-                    if (!t.is_boundary(m))
-                    {
-                        q.push(t.sw(3, m));
-                    }
-                    if (!t.sw(2, m).is_boundary(m))
-                    {
-                        q.push(t.sw(2, m).sw(3, m));
-                    }
-                }
-            }
-            break;
-        }
-        case 2:
-        {
-            sc.add_simplex(Simplex(3, s.tuple()));
-            if (!s.tuple().is_boundary(m))
-            {
-                sc.add_simplex(Simplex(3, s.tuple().sw(3, m)));
-            }
-            break;
-        }
-        case 3:
-        {
-            sc.add_simplex(s);
-            break;
-        }
-        default:
-        {
-            assert(false);
-            break;
-        }
-        }
+        const size_t first = buffer.size();
+        append_simplex_with_boundary(s, m, buffer);
+        buffer.erase(buffer.begin() + first); // s itself
     }
 
-    const auto top_simplices = sc.get_simplices();
-    for (const Simplex &ts : top_simplices)
+    // ∂s for all d-simplices s pointed to by _tuples_, navigated in lockstep
+    void add_boundary(const std::vector<Tuple> &tuples, const int &d, const Mesh &m)
     {
-        sc.unify_with_complex(boundary(ts, m));
+        append_boundary_batch(tuples, d, m, buffer);
     }
-    return sc;
-}
 
-SimplicialComplex link(const Simplex &s, const Mesh &m)
-{
-    SimplicialComplex sc_clst = closed_star(s, m);
-    SimplicialComplex sc;
-    for (const Simplex &ss : sc_clst.get_simplices())
+    // ∂s∪{s} for all d-simplices s pointed to by _tuples_, navigated in lockstep
+    void add_simplices_with_boundary(const std::vector<Tuple> &tuples, const int &d, const Mesh &m)
     {
-        if (!simplices_w_boundary_intersect(s, ss, m))
+        for (const Tuple &t : tuples)
         {
-            sc.add_simplex(ss);
+            buffer.emplace_back(Simplex(d, t));
         }
+        append_boundary_batch(tuples, d, m, buffer);
+    }
+
+    void add_complex(const SimplicialComplex &sc)
+    {
+        buffer.insert(buffer.end(), sc.get_simplices().begin(), sc.get_simplices().end());
+    }
+
+    /**
+     * @brief deduplicate and build the complex, the builder is empty afterwards
+     */
+    SimplicialComplex finalize()
+    {
+        std::sort(buffer.begin(), buffer.end());
+        buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+        SimplicialComplex sc = SimplicialComplex::from_sorted(std::move(buffer));
+        buffer.clear();
+        return sc;
     }
+};
 
-    return sc;
+//////////////////////////////////
+// parallel helpers
+//////////////////////////////////
+// ranges smaller than this run on the calling thread, starting threads would cost more than the work
+constexpr size_t parallel_grain_size = 1024;
+
+/**
+ * @brief number of chunks parallel_for splits a range of size n into, every chunk has at least grain_size elements
+ */
+inline size_t parallel_chunk_count(const size_t &n, const size_t &grain_size = parallel_grain_size)
+{
+    const size_t n_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t max_chunks = n / std::max<size_t>(1, grain_size);
+    return std::max<size_t>(1, std::min(n_threads, max_chunks));
 }
 
-SimplicialComplex open_star(const Simplex &s, const Mesh &m)
+/**
+ * @brief run f(begin, end, chunk_id) on contiguous chunks of [0, n), one thread per chunk
+ *
+ * chunk_id is in [0, parallel_chunk_count(n, grain_size)) and can be used to index per-thread buffers.
+ * Pass a grain_size of 1 when every element is a large piece of work.
+ */
+template <typename Func>
+void parallel_for(const size_t &n, Func &&f, const size_t &grain_size = parallel_grain_size)
 {
-    SimplicialComplex sc_clst = closed_star(s, m);
-    SimplicialComplex sc;
-    sc.add_simplex(s);
-    for (const Simplex &ss : sc_clst.get_simplices())
+    const size_t n_chunks = parallel_chunk_count(n, grain_size);
+    if (n_chunks == 1)
     {
-        if (ss.dimension() <= s.dimension())
+        if (n > 0)
         {
-            continue;
+            f(size_t(0), n, size_t(0));
         }
-        if (simplices_w_boundary_intersect(s, ss, m))
+        return;
+    }
+
+    const size_t chunk_size = (n + n_chunks - 1) / n_chunks;
+    std::vector<std::thread> threads;
+    threads.reserve(n_chunks);
+    for (size_t i = 0; i < n_chunks; ++i)
+    {
+        const size_t begin = i * chunk_size;
+        const size_t end = std::min(n, begin + chunk_size);
+        if (begin >= end)
         {
-            sc.add_simplex(ss);
+            break;
         }
+        threads.emplace_back([&f, begin, end, i]() { f(begin, end, i); });
+    }
+    for (std::thread &th : threads)
+    {
+        th.join();
     }
-
-    return sc;
 }
 
 //////////////////////////////////
-// check link condition
-// input Tuple t --> edge (a,b)
-// check if lnk(a) ∩ lnk(b) == lnk(ab)
+// List of Operators
+// bd: boundary
+// clbd: closed boudnary
+// st: start
+// clst: closed star
+// lnk: link
 //////////////////////////////////
-bool link_cond(Tuple t, const Mesh &m)
-{
-    SimplicialComplex lhs = link(Simplex(t, 0), m); // lnk(a)
-    lhs.unify_with_complex(link(Simplex(t.sw(0, m), 0), m)); // Union lnk(b)
 
-    SimplicialComplex rhs = link(Simplex(t, 1), m); // lnk(ab)
-    return (lhs == rhs);
+// ∂s
+/**
+ * @brief get the boundary of a simplex
+ */
+inline SimplicialComplex boundary(const Simplex &s, const Mesh &m)
+{
+    SimplicialComplexBuilder builder;
+    builder.add_boundary(s, m);
+    return builder.finalize();
 }
 
-//////////////////////////////////
-// k-ring
-//////////////////////////////////
 /**
- * @brief get one ring neighbors of vertex in _t_
+ * @brief get the union of the boundaries of all d-simplices pointed to by _tuples_
  */
-std::vector<Tuple> vertex_one_ring(Tuple t, const Mesh &m)
+inline SimplicialComplex boundary(const std::vector<Tuple> &tuples, const int &d, const Mesh &m)
 {
-    Simplex s(0, t);
-    SimplicialComplex sc_link = link(s, m);
-    std::set<Simplex> one_ring_simplices = sc_link.get_simplices(0);
-    return std::vector<Tuple>(one_ring_simplices.begin(), one_ring_simplices.end());
+    SimplicialComplexBuilder builder;
+    builder.reserve(tuples.size() * detail::face_chains(d).size());
+    builder.add_boundary(tuples, d, m);
+    return builder.finalize();
 }
 
-std::vector<Tuple> k_ring(Tuple t, const Mesh &m, int k)
+// ∂s∪{s}
+/**
+ * @brief get complex of a simplex and its boundary
+ */
+inline SimplicialComplex simplex_with_boundary(const Simplex &s, const Mesh &m)
 {
-    if (k < 1)
-        return {};
+    SimplicialComplexBuilder builder;
+    builder.add_simplex_with_boundary(s, m);
+    return builder.finalize();
+}
 
-    SimplicialComplex sc(vertex_one_ring(t, m), 0);
-    for (int i = 2; i <= k; ++i)
-    {
-        const auto simplices = sc.get_simplices();
-        for (const Simplex &s : simplices)
-        {
-            SimplicialComplex sc_or(vertex_one_ring(s.tuple(), m), 0);
-            sc.unify_with_complex(sc_or);
+// Simplex s1,s2, check if A∩B!=∅
+// check is intersect(∂s1, ∂s2) has intersections
+/**
+ * @brief check if simplices with their boundary intersect
+ */
+inline bool simplices_w_boundary_intersect(const Simplex &s1, const Simplex &s2, const Mesh &m)
+{
+    SimplicialComplex s1_bd = simplex_with_boundary(s1, m);
+    SimplicialComplex s2_bd = simplex_with_boundary(s2, m);
+    SimplicialComplex s1_s2_int = get_intersection(s1_bd, s2_bd);
+    return (s1_s2_int.get_simplices().size() != 0);
+}
+
+namespace detail
+{
+    /**
+     * @brief buffers of a traversal over the cells around a simplex, reused across traversals
+     */
+    struct CellTraversal
+    {
+        std::vector<long> visited; // sorted cell ids
+        std::vector<Tuple> frontier;
+        std::vector<Tuple> facets;
+        std::vector<Tuple> neighbors;
+
+        /**
+         * @returns false if the cell was visited before
+         */
+        bool visit(const long &cell)
+        {
+            const auto it = std::lower_bound(visited.begin(), visited.end(), cell);
+            if (it != visited.end() && *it == cell)
+            {
+                return false;
+            }
+            visited.insert(it, cell);
+            return true;
+        }
+    };
+
+    /**
+     * @brief append the cells reachable from _seed_ through the facets given by _facet_chains_ to _out_, level by level
+     *
+     * All cells of a level are expanded in lockstep: every facet chain is applied to the whole
+     * frontier, then all interior facets switch to their neighbor cell in one sw_batch().
+     */
+    inline void expand_cells(const Tuple &seed, const std::vector<std::vector<int>> &facet_chains, const Mesh &m, CellTraversal &tr, std::vector<Tuple> &out)
+    {
+        const int &cell_dim = m.cell_dimension();
+        tr.visit(Simplex(cell_dim, seed).global_id());
+        out.push_back(seed);
+        tr.frontier.assign(1, seed);
+        while (!tr.frontier.empty())
+        {
+            tr.neighbors.clear();
+            for (const std::vector<int> &chain : facet_chains)
+            {
+                tr.facets = tr.frontier;
+                sw_chain(tr.facets, chain, m);
+                std::copy_if(tr.facets.begin(), tr.facets.end(), std::back_inserter(tr.neighbors), [&m](const Tuple &f) { return !f.is_boundary(m); });
+            }
+            m.sw_batch(tr.neighbors.data(), tr.neighbors.size(), cell_dim);
+
+            tr.frontier.clear();
+            for (const Tuple &t : tr.neighbors)
+            {
+                if (tr.visit(Simplex(cell_dim, t).global_id()))
+                {
+                    tr.frontier.push_back(t);
+                    out.push_back(t);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief append the top dimension cells containing s to _out_, see top_cofaces()
+     *
+     * Only the buffers of _tr_ are used, so repeated queries do not allocate once they have grown.
+     */
+    inline void append_top_cofaces(const Simplex &s, const Mesh &m, CellTraversal &tr, std::vector<Tuple> &out)
+    {
+        // facets around the simplex of a cell tuple, as switch sequences
+        static const std::vector<std::vector<int>> tri_vertex_facets = {{}, {1}};
+        static const std::vector<std::vector<int>> tet_vertex_facets = {{}, {2}, {1, 2}};
+        static const std::vector<std::vector<int>> tet_edge_facets = {{}, {2}};
+
+        const int &cell_dim = m.cell_dimension(); // TODO: 2 for trimesh, 3 for tetmesh need it in Mesh class
+        tr.visited.clear();
+        const auto visit = [&](const Tuple &t) {
+            if (tr.visit(Simplex(cell_dim, t).global_id()))
+            {
+                out.push_back(t);
+            }
+        };
+
+        if (cell_dim == 2)
+        {
+            switch (s.dimension())
+            {
+            case 0:
+                expand_cells(s.tuple(), tri_vertex_facets, m, tr, out);
+                break;
+            case 1:
+                visit(s.tuple());
+                if (!s.tuple().is_boundary(m))
+                {
+                    visit(s.tuple().sw(2, m));
+                }
+                break;
+            case 2:
+                visit(s.tuple());
+                break;
+            default:
+                assert(false);
+                break;
+            }
+        }
+        else if (cell_dim == 3)
+        {
+            switch (s.dimension())
+            {
+            case 0:
+            {
+                expand_cells(s.tuple(), tet_vertex_facets, m, tr, out);
+                break;
+            }
+            case 1:
+            {
+                expand_cells(s.tuple(), tet_edge_facets, m, tr, out);
+                break;
+            }
+            case 2:
+            {
+                visit(s.tuple());
+                if (!s.tuple().is_boundary(m))
+                {
+                    visit(s.tuple().sw(3, m));
+                }
+                break;
+            }
+            case 3:
+            {
+                visit(s.tuple());
+                break;
+            }
+            default:
+            {
+                assert(false);
+                break;
+            }
+            }
+        }
+    }
+} // namespace detail
+
+/**
+ * @brief get the top dimension cells containing s
+ *
+ * Every returned tuple points to the same vertex (and edge, face) as s.tuple().
+ */
+inline std::vector<Tuple> top_cofaces(const Simplex &s, const Mesh &m)
+{
+    detail::CellTraversal tr;
+    std::vector<Tuple> ret;
+    detail::append_top_cofaces(s, m, tr, ret);
+    return ret;
+}
+
+inline SimplicialComplex closed_star(const Simplex &s, const Mesh &m)
+{
+    const int &cell_dim = m.cell_dimension();
+    const std::vector<Tuple> cells = top_cofaces(s, m);
+    SimplicialComplexBuilder builder;
+    builder.reserve(cells.size() * (cell_dim == 3 ? 15 : 7));
+    builder.add_simplices_with_boundary(cells, cell_dim, m);
+    return builder.finalize();
+}
+
+namespace detail
+{
+    /**
+     * @brief add the simplices ss of closed_star(s) for which keep(ss, shares a vertex with s) holds
+     *
+     * Compares vertex ids only, no complex is built per simplex.
+     */
+    template <typename Predicate>
+    void filter_closed_star(const Simplex &s, const Mesh &m, SimplicialComplexBuilder &builder, Predicate &&keep)
+    {
+        const int &cell_dim = m.cell_dimension();
+        std::vector<SimplexId> faces;
+        append_simplex_with_boundary(s, m, faces);
+        std::vector<long> s_vertices;
+        for (const SimplexId &f : faces)
+        {
+            if (f.dimension() == 0)
+            {
+                s_vertices.push_back(f.global_id());
+            }
+        }
+
+        std::vector<Simplex> cell_faces;
+        for (const Tuple &t : top_cofaces(s, m))
+        {
+            cell_faces.clear();
+            append_simplex_with_boundary(Simplex(cell_dim, t), m, cell_faces);
+            for (const Simplex &cf : cell_faces)
+            {
+                faces.clear();
+                append_simplex_with_boundary(cf, m, faces);
+                const bool shares_vertex = std::any_of(faces.begin(), faces.end(), [&s_vertices](const SimplexId &f) {
+                    return f.dimension() == 0 && std::find(s_vertices.begin(), s_vertices.end(), f.global_id()) != s_vertices.end();
+                });
+                if (keep(cf, shares_vertex))
+                {
+                    builder.add_simplex(cf);
+                }
+            }
+        }
+    }
+} // namespace detail
+
+inline SimplicialComplex link(const Simplex &s, const Mesh &m)
+{
+    SimplicialComplexBuilder builder;
+    detail::filter_closed_star(s, m, builder, [](const Simplex &, const bool &shares_vertex) { return !shares_vertex; });
+    return builder.finalize();
+}
+
+inline SimplicialComplex open_star(const Simplex &s, const Mesh &m)
+{
+    SimplicialComplexBuilder builder;
+    builder.add_simplex(s);
+    detail::filter_closed_star(s, m, builder, [&s](const Simplex &ss, const bool &shares_vertex) {
+        return shares_vertex && ss.dimension() > s.dimension();
+    });
+    return builder.finalize();
+}
+
+//////////////////////////////////
+// closure of a large set of simplices
+//////////////////////////////////
+namespace detail
+{
+    /**
+     * @brief merge two sorted, duplicate-free buffers into one
+     */
+    inline std::vector<SimplexId> merge_unique(const std::vector<SimplexId> &v, const std::vector<SimplexId> &w)
+    {
+        std::vector<SimplexId> ret;
+        ret.reserve(v.size() + w.size());
+        std::merge(v.begin(), v.end(), w.begin(), w.end(), std::back_inserter(ret));
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    }
+
+    /**
+     * @brief merge sorted, duplicate-free buffers pairwise in parallel rounds
+     */
+    inline std::vector<SimplexId> parallel_merge_unique(std::vector<std::vector<SimplexId>> buffers)
+    {
+        if (buffers.empty())
+        {
+            return {};
+        }
+        while (buffers.size() > 1)
+        {
+            std::vector<std::vector<SimplexId>> merged((buffers.size() + 1) / 2);
+            parallel_for(merged.size(), [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (2 * i + 1 < buffers.size())
+                    {
+                        merged[i] = merge_unique(buffers[2 * i], buffers[2 * i + 1]);
+                    }
+                    else
+                    {
+                        merged[i] = std::move(buffers[2 * i]);
+                    }
+                }
+            }, 1);
+            buffers = std::move(merged);
+        }
+        return std::move(buffers[0]);
+    }
+} // namespace detail
+
+/**
+ * @brief get the complex of the given simplices and all their faces
+ *
+ * Faces are enumerated in parallel into per-thread buffers, every buffer is sorted and
+ * deduplicated by its thread, and the sorted buffers are merged pairwise in parallel.
+ * Inputs below parallel_grain_size stay on the calling thread.
+ */
+inline SimplicialComplex closure(const std::vector<Simplex> &simplices, const Mesh &m)
+{
+    std::vector<std::vector<SimplexId>> buffers(parallel_chunk_count(simplices.size()));
+    parallel_for(simplices.size(), [&](size_t begin, size_t end, size_t chunk_id) {
+        std::vector<SimplexId> &buffer = buffers[chunk_id];
+        buffer.reserve(15 * (end - begin)); // a tet has 15 faces including itself
+        for (size_t i = begin; i < end; ++i)
+        {
+            append_simplex_with_boundary(simplices[i], m, buffer);
+        }
+        std::sort(buffer.begin(), buffer.end());
+        buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+    });
+
+    return SimplicialComplex::from_sorted(detail::parallel_merge_unique(std::move(buffers)));
+}
+
+//////////////////////////////////
+// star and link of a subcomplex
+// one multi-source traversal over the cells touching the vertices of the subcomplex
+//////////////////////////////////
+namespace detail
+{
+    /**
+     * @brief global ids of the vertices of all simplices in sc
+     */
+    inline std::set<long> vertex_ids(const SimplicialComplex &sc, const Mesh &m)
+    {
+        std::set<long> ret;
+        std::vector<SimplexId> faces;
+        for (const SimplexId &id : sc.get_simplices())
+        {
+            if (id.dimension() == 0)
+            {
+                ret.insert(id.global_id());
+                continue;
+            }
+            faces.clear();
+            append_simplex_with_boundary(id.simplex(m), m, faces);
+            for (const SimplexId &f : faces)
+            {
+                if (f.dimension() == 0)
+                {
+                    ret.insert(f.global_id());
+                }
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief tuples of the facets of the cell in _t_, their sw(cell_dim) is the neighbor cell
+     */
+    inline std::vector<Tuple> cell_facets(const Tuple &t, const Mesh &m)
+    {
+        if (m.cell_dimension() == 2)
+        {
+            return {t, t.sw(1, m), t.sw(0, m).sw(1, m)};
+        }
+        return {t, t.sw(2, m), t.sw(1, m).sw(2, m), t.sw(0, m).sw(1, m).sw(2, m)};
+    }
+
+    inline std::vector<long> cell_vertex_ids(const long &cell, const Mesh &m)
+    {
+        const int &cell_dim = m.cell_dimension();
+        std::vector<SimplexId> faces;
+        append_simplex_with_boundary(Simplex(cell_dim, m.tuple_from_id(cell_dim, cell)), m, faces);
+        std::vector<long> ret;
+        for (const SimplexId &f : faces)
+        {
+            if (f.dimension() == 0)
+            {
+                ret.push_back(f.global_id());
+            }
+        }
+        return ret;
+    }
+
+    inline std::vector<Tuple> top_cofaces(const SimplicialComplex &sc, const std::set<long> &vertices, const Mesh &m)
+    {
+        const int &cell_dim = m.cell_dimension();
+        std::set<long> visited;
+        std::vector<Tuple> ret;
+        std::vector<SimplexId> faces;
+
+        std::queue<Tuple> q;
+        for (const long &v : vertices)
+        {
+            q.push(m.tuple_from_id(0, v));
+        }
+        while (!q.empty())
+        {
+            const Tuple t = q.front();
+            q.pop();
+            if (!visited.insert(Simplex(cell_dim, t).global_id()).second)
+            {
+                continue;
+            }
+
+            faces.clear();
+            append_simplex_with_boundary(Simplex(cell_dim, t), m, faces);
+            const bool touches_sc = std::any_of(faces.begin(), faces.end(), [&vertices](const SimplexId &f) {
+                return f.dimension() == 0 && vertices.count(f.global_id()) > 0;
+            });
+            if (!touches_sc)
+            {
+                continue;
+            }
+            // a cell touching a vertex of sc is only in the star if it contains a simplex of sc
+            const bool contains_sc = std::any_of(faces.begin(), faces.end(), [&sc](const SimplexId &f) {
+                return sc.contains(f);
+            });
+            if (contains_sc)
+            {
+                ret.push_back(t);
+            }
+
+            for (const Tuple &f : cell_facets(t, m))
+            {
+                if (!f.is_boundary(m))
+                {
+                    q.push(f.sw(cell_dim, m));
+                }
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief simplices of the closed star of sc for which keep(faces of the simplex) holds
+     */
+    template <typename Predicate>
+    SimplicialComplex filter_closed_star(const SimplicialComplex &sc, const std::set<long> &vertices, const Mesh &m, Predicate &&keep)
+    {
+        const int &cell_dim = m.cell_dimension();
+        std::set<SimplexId> visited;
+        SimplicialComplexBuilder builder;
+        std::vector<Simplex> cell_faces;
+        std::vector<SimplexId> faces;
+        for (const Tuple &t : top_cofaces(sc, vertices, m))
+        {
+            cell_faces.clear();
+            append_simplex_with_boundary(Simplex(cell_dim, t), m, cell_faces);
+            for (const Simplex &cf : cell_faces)
+            {
+                if (!visited.insert(SimplexId(cf)).second)
+                {
+                    continue;
+                }
+                faces.clear();
+                append_simplex_with_boundary(cf, m, faces);
+                if (keep(faces))
+                {
+                    builder.add_simplex(cf);
+                }
+            }
+        }
+        return builder.finalize();
+    }
+} // namespace detail
+
+/**
+ * @brief get the top dimension cells containing at least one simplex of sc
+ */
+inline std::vector<Tuple> top_cofaces(const SimplicialComplex &sc, const Mesh &m)
+{
+    return detail::top_cofaces(sc, detail::vertex_ids(sc, m), m);
+}
+
+inline SimplicialComplex closed_star(const SimplicialComplex &sc, const Mesh &m)
+{
+    // regions are small and many, so this stays on the calling thread
+    const int &cell_dim = m.cell_dimension();
+    SimplicialComplexBuilder builder;
+    builder.add_simplices_with_boundary(top_cofaces(sc, m), cell_dim, m);
+    return builder.finalize();
+}
+
+/**
+ * @brief union of open_star(s) over all s in sc
+ *
+ * A simplex of a cell around sc is kept if it is in sc, or if it shares a vertex with a lower
+ * dimensional simplex of sc in the same cell. For a closed sc these are the simplices having a face in sc.
+ */
+inline SimplicialComplex open_star(const SimplicialComplex &sc, const Mesh &m)
+{
+    const int &cell_dim = m.cell_dimension();
+    SimplicialComplexBuilder builder;
+    std::vector<Simplex> cell_faces;
+    std::vector<std::vector<long>> face_vertices;
+    std::vector<size_t> sc_faces;
+    std::vector<SimplexId> faces;
+    for (const Tuple &t : top_cofaces(sc, m))
+    {
+        cell_faces.clear();
+        append_simplex_with_boundary(Simplex(cell_dim, t), m, cell_faces);
+        face_vertices.resize(cell_faces.size());
+        sc_faces.clear();
+        for (size_t i = 0; i < cell_faces.size(); ++i)
+        {
+            faces.clear();
+            append_simplex_with_boundary(cell_faces[i], m, faces);
+            face_vertices[i].clear();
+            for (const SimplexId &f : faces)
+            {
+                if (f.dimension() == 0)
+                {
+                    face_vertices[i].push_back(f.global_id());
+                }
+            }
+            if (sc.contains(SimplexId(cell_faces[i])))
+            {
+                sc_faces.push_back(i);
+            }
+        }
+
+        for (size_t i = 0; i < cell_faces.size(); ++i)
+        {
+            const std::vector<long> &vi = face_vertices[i];
+            const bool keep = std::any_of(sc_faces.begin(), sc_faces.end(), [&](const size_t &j) {
+                if (j == i)
+                {
+                    return true;
+                }
+                if (cell_faces[j].dimension() >= cell_faces[i].dimension())
+                {
+                    return false;
+                }
+                const std::vector<long> &vj = face_vertices[j];
+                return std::any_of(vj.begin(), vj.end(), [&vi](const long &v) {
+                    return std::find(vi.begin(), vi.end(), v) != vi.end();
+                });
+            });
+            if (keep)
+            {
+                builder.add_simplex(cell_faces[i]);
+            }
+        }
+    }
+    return builder.finalize();
+}
+
+/**
+ * @brief simplices of the closed star that share no vertex with sc
+ */
+inline SimplicialComplex link(const SimplicialComplex &sc, const Mesh &m)
+{
+    const std::set<long> vertices = detail::vertex_ids(sc, m);
+    return detail::filter_closed_star(sc, vertices, m, [&vertices](const std::vector<SimplexId> &faces) {
+        return std::none_of(faces.begin(), faces.end(), [&vertices](const SimplexId &f) {
+            return f.dimension() == 0 && vertices.count(f.global_id()) > 0;
+        });
+    });
+}
+
+//////////////////////////////////
+// count-only queries
+// sizes come straight from the traversal, using incidence arithmetic
+// (e.g. every interior face is shared by two cells) instead of dedup sets
+//////////////////////////////////
+/**
+ * @brief number of simplices per dimension
+ */
+using SimplexCounts = std::array<int, 4>;
+
+namespace detail
+{
+    struct EdgeFan
+    {
+        int n_cells = 0;
+        bool is_closed = false;
+    };
+
+    /**
+     * @brief rotate around the edge of a tet mesh tuple, without a visited set
+     */
+    inline EdgeFan tet_edge_fan(const Tuple &t, const Mesh &m)
+    {
+        EdgeFan fan;
+        const int start_cell = Simplex(3, t).global_id();
+
+        // rotate in the sw(2) direction until we hit the boundary or return to t
+        Tuple cur = t;
+        while (true)
+        {
+            ++fan.n_cells;
+            const Tuple face = cur.sw(2, m);
+            if (face.is_boundary(m))
+            {
+                break;
+            }
+            cur = face.sw(3, m);
+            if (Simplex(3, cur).global_id() == start_cell)
+            {
+                fan.is_closed = true;
+                return fan;
+            }
+        }
+
+        // open fan: collect the cells on the other side of t's face
+        if (t.is_boundary(m))
+        {
+            return fan;
+        }
+        cur = t.sw(3, m);
+        while (true)
+        {
+            ++fan.n_cells;
+            const Tuple face = cur.sw(2, m);
+            if (face.is_boundary(m))
+            {
+                break;
+            }
+            cur = face.sw(3, m);
+        }
+        return fan;
+    }
+} // namespace detail
+
+/**
+ * @brief number of top dimension cells around the edge in _t_
+ */
+inline int edge_valence(const Tuple &t, const Mesh &m)
+{
+    if (m.cell_dimension() == 2)
+    {
+        return t.is_boundary(m) ? 1 : 2;
+    }
+    return detail::tet_edge_fan(t, m).n_cells;
+}
+
+/**
+ * @brief per-dimension sizes of link(s), without building the link
+ */
+inline SimplexCounts link_counts(const Simplex &s, const Mesh &m)
+{
+    SimplexCounts counts = {0, 0, 0, 0};
+    const int &cell_dim = m.cell_dimension();
+    const int link_dim = cell_dim - s.dimension() - 1;
+    if (link_dim < 0)
+    {
+        return counts;
+    }
+
+    if (cell_dim == 3 && s.dimension() == 1)
+    {
+        // the link of an edge is a cycle (closed fan) or a path (open fan)
+        const detail::EdgeFan fan = detail::tet_edge_fan(s.tuple(), m);
+        counts[1] = fan.n_cells;
+        counts[0] = fan.is_closed ? fan.n_cells : fan.n_cells + 1;
+        return counts;
+    }
+
+    const std::vector<Tuple> cells = top_cofaces(s, m);
+    const int n_cells = cells.size();
+    // every cell contributes the simplex opposite to s
+    counts[link_dim] = n_cells;
+
+    if (s.dimension() == cell_dim - 1)
+    {
+        return counts;
+    }
+
+    if (cell_dim == 2)
+    {
+        // vertex in a triangle mesh: each incident edge is shared by 2 triangles, or 1 on the boundary
+        int n_boundary_edges = 0;
+        for (const Tuple &t : cells)
+        {
+            n_boundary_edges += t.is_boundary(m) ? 1 : 0;
+            n_boundary_edges += t.sw(1, m).is_boundary(m) ? 1 : 0;
+        }
+        counts[0] = (2 * n_cells + n_boundary_edges) / 2;
+        return counts;
+    }
+
+    // vertex in a tet mesh: each incident face is shared by 2 tets, or 1 on the boundary
+    int n_boundary_faces = 0;
+    std::set<int> link_vertices;
+    for (const Tuple &t : cells)
+    {
+        n_boundary_faces += t.is_boundary(m) ? 1 : 0;
+        n_boundary_faces += t.sw(2, m).is_boundary(m) ? 1 : 0;
+        n_boundary_faces += t.sw(1, m).sw(2, m).is_boundary(m) ? 1 : 0;
+        // edges are not determined by the cell count, dedup the opposite vertices
+        link_vertices.insert(Simplex(0, t.sw(0, m)).global_id());
+        link_vertices.insert(Simplex(0, t.sw(1, m).sw(0, m)).global_id());
+        link_vertices.insert(Simplex(0, t.sw(2, m).sw(1, m).sw(0, m)).global_id());
+    }
+    counts[1] = (3 * n_cells + n_boundary_faces) / 2;
+    counts[0] = link_vertices.size();
+    return counts;
+}
+
+/**
+ * @brief per-dimension sizes of open_star(s), without building the star
+ *
+ * open_star() keeps s and every higher dimensional simplex of closed_star(s) that shares a
+ * vertex with s. These are the joins of a non-empty face of s with a link simplex, so with
+ * n = s.dimension() + 1 and L[-1] = 1 for the empty link simplex:
+ * counts[k] = sum over i >= 0, i + j = k - 1 of C(n, i + 1) * L[j]
+ * For a vertex these are exactly the cofaces of s. For an edge or a face it also counts
+ * simplices like ACD around the edge AB, which only share one vertex with s.
+ */
+inline SimplexCounts open_star_counts(const Simplex &s, const Mesh &m)
+{
+    const SimplexCounts lc = link_counts(s, m);
+    const auto link_count = [&lc](const int &j) { return j < 0 ? 1 : lc[j]; };
+    const auto binomial = [](const int &n, const int &k) {
+        int ret = 1;
+        for (int i = 0; i < k; ++i)
+        {
+            ret = ret * (n - i) / (i + 1);
+        }
+        return ret;
+    };
+
+    const int n = s.dimension() + 1;
+    SimplexCounts counts = {0, 0, 0, 0};
+    counts[s.dimension()] = 1;
+    for (int k = s.dimension() + 1; k < 4; ++k)
+    {
+        // faces of s of dimension i joined with link simplices of dimension k - i - 1
+        for (int i = 0; i <= s.dimension(); ++i)
+        {
+            counts[k] += binomial(n, i + 1) * link_count(k - i - 1);
+        }
+    }
+    return counts;
+}
+
+/**
+ * @brief number of edges incident to the vertex in _t_
+ */
+inline int vertex_valence(const Tuple &t, const Mesh &m)
+{
+    return link_counts(Simplex(0, t), m)[0];
+}
+
+//////////////////////////////////
+// check link condition
+// input Tuple t --> edge (a,b)
+// check if lnk(a) ∩ lnk(b) == lnk(ab)
+//////////////////////////////////
+namespace detail
+{
+    inline void sort_unique(std::vector<long> &v)
+    {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+
+    inline bool sorted_contains(const std::vector<long> &v, const long &x)
+    {
+        return std::binary_search(v.begin(), v.end(), x);
+    }
+} // namespace detail
+
+/**
+ * @brief link condition for tet meshes, stops at the first violating simplex
+ *
+ * lnk(ab) ⊆ lnk(a) ∩ lnk(b) always holds, so only simplices in both lnk(a) and lnk(b) but
+ * not in lnk(ab) are searched for. lnk(ab) is the ring of edges opposite to ab and is built
+ * first. The common part of lnk(a) and lnk(b) is streamed vertices first, then edges, then
+ * triangles; lnk(ab) has no triangles, so any common triangle is a violation.
+ */
+inline bool link_cond_tet(const Tuple &t, const Mesh &m)
+{
+    assert(m.cell_dimension() == 3);
+
+    // all tuples point to (A, AB) with A = a or b, the opposite simplices are in the link of A (or AB)
+    const std::vector<Tuple> tets_ab = top_cofaces(Simplex(1, t), m);
+    const std::vector<Tuple> tets_a = top_cofaces(Simplex(0, t), m);
+    const std::vector<Tuple> tets_b = top_cofaces(Simplex(0, t.sw(0, m)), m);
+
+    const auto C = [&m](const Tuple &tt) { return tt.sw(1, m).sw(0, m); };
+    const auto D = [&m](const Tuple &tt) { return tt.sw(2, m).sw(1, m).sw(0, m); };
+    const auto vid = [](const Tuple &tt) -> long { return Simplex(0, tt).global_id(); };
+    const auto eid = [](const Tuple &tt) -> long { return Simplex(1, tt).global_id(); };
+
+    // lnk(ab): vertices C, D and edge CD of every tet around ab
+    std::vector<long> lnk_ab_vertices;
+    std::vector<long> lnk_ab_edges;
+    for (const Tuple &tt : tets_ab)
+    {
+        lnk_ab_vertices.push_back(vid(C(tt)));
+        lnk_ab_vertices.push_back(vid(D(tt)));
+        lnk_ab_edges.push_back(eid(tt.sw(1, m).sw(0, m).sw(2, m).sw(1, m))); // CD
+    }
+    detail::sort_unique(lnk_ab_vertices);
+    detail::sort_unique(lnk_ab_edges);
+
+    // vertices: B, C, D of every tet around A
+    std::vector<long> lnk_a_vertices;
+    for (const Tuple &tt : tets_a)
+    {
+        lnk_a_vertices.push_back(vid(tt.sw(0, m)));
+        lnk_a_vertices.push_back(vid(C(tt)));
+        lnk_a_vertices.push_back(vid(D(tt)));
+    }
+    detail::sort_unique(lnk_a_vertices);
+    for (const Tuple &tt : tets_b)
+    {
+        for (const long &v : {vid(tt.sw(0, m)), vid(C(tt)), vid(D(tt))})
+        {
+            if (detail::sorted_contains(lnk_a_vertices, v) && !detail::sorted_contains(lnk_ab_vertices, v))
+            {
+                return false;
+            }
+        }
+    }
+
+    // edges: BC, BD, CD of every tet around A
+    const auto opposite_edges = [&](const Tuple &tt) -> std::array<long, 3> {
+        return {
+            eid(tt.sw(0, m).sw(1, m)),                   // BC
+            eid(tt.sw(0, m).sw(2, m).sw(1, m)),          // BD
+            eid(tt.sw(1, m).sw(0, m).sw(2, m).sw(1, m)), // CD
+        };
+    };
+    std::vector<long> lnk_a_edges;
+    for (const Tuple &tt : tets_a)
+    {
+        for (const long &e : opposite_edges(tt))
+        {
+            lnk_a_edges.push_back(e);
+        }
+    }
+    detail::sort_unique(lnk_a_edges);
+    for (const Tuple &tt : tets_b)
+    {
+        for (const long &e : opposite_edges(tt))
+        {
+            if (detail::sorted_contains(lnk_a_edges, e) && !detail::sorted_contains(lnk_ab_edges, e))
+            {
+                return false;
+            }
+        }
+    }
+
+    // triangles: BCD of every tet around A
+    std::vector<long> lnk_a_faces;
+    for (const Tuple &tt : tets_a)
+    {
+        lnk_a_faces.push_back(Simplex(2, tt.sw(0, m).sw(1, m).sw(2, m)).global_id());
+    }
+    detail::sort_unique(lnk_a_faces);
+    for (const Tuple &tt : tets_b)
+    {
+        if (detail::sorted_contains(lnk_a_faces, Simplex(2, tt.sw(0, m).sw(1, m).sw(2, m)).global_id()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline bool link_cond(Tuple t, const Mesh &m)
+{
+    if (m.cell_dimension() == 3)
+    {
+        return link_cond_tet(t, m);
+    }
+
+    SimplicialComplex lnk_a = link(Simplex(0, t), m);           // lnk(a)
+    SimplicialComplex lnk_b = link(Simplex(0, t.sw(0, m)), m);  // lnk(b)
+    SimplicialComplex lhs = get_intersection(lnk_a, lnk_b);     // Intersection
+
+    SimplicialComplex rhs = link(Simplex(1, t), m); // lnk(ab)
+    return (lhs == rhs);
+}
+
+//////////////////////////////////
+// k-ring
+//////////////////////////////////
+/**
+ * @brief get one ring neighbors of vertex in _t_
+ */
+inline std::vector<Tuple> vertex_one_ring(Tuple t, const Mesh &m)
+{
+    Simplex s(0, t);
+    SimplicialComplex sc_link = link(s, m);
+    std::vector<Tuple> ret;
+    for (const SimplexId &v : sc_link.get_simplices(0))
+    {
+        ret.push_back(v.simplex(m).tuple());
+    }
+    return ret;
+}
+
+/**
+ * @brief get vertices within k edges of the vertex in _t_
+ *
+ * Frontier BFS: only the vertices reached in the previous level are expanded.
+ */
+inline std::vector<Tuple> k_ring(Tuple t, const Mesh &m, int k)
+{
+    if (k < 1)
+        return {};
+
+    std::vector<Tuple> frontier = vertex_one_ring(t, m);
+    std::set<long> visited;
+    for (const Tuple &ft : frontier)
+    {
+        visited.insert(Simplex(0, ft).global_id());
+    }
+    std::vector<Tuple> ret = frontier;
+    for (int i = 2; i <= k && !frontier.empty(); ++i)
+    {
+        std::vector<Tuple> next_frontier;
+        for (const Tuple &ft : frontier)
+        {
+            for (const Tuple &nt : vertex_one_ring(ft, m))
+            {
+                if (visited.insert(Simplex(0, nt).global_id()).second)
+                {
+                    next_frontier.push_back(nt);
+                    ret.push_back(nt);
+                }
+            }
         }
+        frontier = std::move(next_frontier);
     }
 
-    std::set<Simplex> k_ring_simplices = sc.get_simplices();
-    return std::vector<Tuple>(k_ring_simplices.begin(), k_ring_simplices.end());
+    return ret;
 }
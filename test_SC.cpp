@@ -2,6 +2,15 @@
 // Psudo code now
 
 #include "SimplicialComplexV2.hpp"
+#include "SimplicialComplex.hpp"
+#include "EdgeScheduling.hpp"
+#include "EdgeCollapse.hpp"
+#include "MeshPartition.hpp"
+#include "MeshReordering.hpp"
+#include "PersistentSimplicialComplex.hpp"
+#include "BatchQueries.hpp"
+#include "BoundarySurface.hpp"
+#include "ManifoldValidation.hpp"
 #include <catch2/catch.hpp>
 
 
@@ -115,7 +124,547 @@ TEST_CASE("k-ring test", "[SC][k-ring]")
     REQUIRE(k_ring(t, m, 3).size() == 6);
 }
 
+TEST_CASE("counts", "[SC][counts]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    const SimplexCounts lnk_0 = link_counts(Simplex(0, t), m);
+    const SimplicialComplex sc = link(Simplex(0, t), m);
+    for (int d = 0; d < 4; ++d)
+    {
+        REQUIRE(lnk_0[d] == sc.get_simplex_count(d));
+    }
+    REQUIRE(lnk_0[0] == 4);
+    REQUIRE(lnk_0[1] == 3);
+
+    REQUIRE(vertex_valence(t, m) == 4);
+    REQUIRE(edge_valence(t, m) == 2);
+    REQUIRE(open_star_counts(Simplex(0, t), m)[2] == 3);
+}
+
+TEST_CASE("counts-tet", "[SC][counts]")
+{
+    auto T = {
+        {0,1,2,3},
+        {0,1,2,4}
+    }; // 2 Tets
+
+    // dump it to (Tet)Mesh
+    Mesh m(T);
+
+    // get the tuple point to V(0), E(01), F(012), T(0123)
+    long hash = 0;
+    Tuple t(0, 0, 0, 0, hash);
+
+    // V(0) uses the (3T + B) / 2 formula, E(01) the fan around the edge
+    for (const Simplex &s : {Simplex(0, t), Simplex(1, t)})
+    {
+        const SimplexCounts lc = link_counts(s, m);
+        const SimplexCounts sc = open_star_counts(s, m);
+        const SimplicialComplex lnk = link(s, m);
+        const SimplicialComplex st = open_star(s, m);
+        for (int d = 0; d < 4; ++d)
+        {
+            REQUIRE(lc[d] == lnk.get_simplex_count(d));
+            REQUIRE(sc[d] == st.get_simplex_count(d));
+        }
+    }
+    REQUIRE(edge_valence(t, m) == 2);
+}
+
+TEST_CASE("collapse driver", "[SC][collapse]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    EdgeCollapseDriver driver(m, [](const Tuple &, const Mesh &) { return 1.0; });
+    driver.push(t);
+    driver.push(t); // the first entry becomes stale
+
+    const auto stats = driver.run(1);
+    REQUIRE(stats.n_collapses == 1);
+    REQUIRE(stats.n_link_cond_evaluations == 1);
+}
+
+TEST_CASE("closure", "[SC][closure]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    std::vector<Simplex> faces = {Simplex(2, t), Simplex(2, t.sw(2, m))};
+    SimplicialComplex sc = closure(faces, m);
+
+    SimplicialComplex expected = get_union(simplex_with_boundary(faces[0], m), simplex_with_boundary(faces[1], m));
+    REQUIRE(sc == expected);
+    REQUIRE(sc.get_size() == 2 + 5 + 4);
+}
+
+TEST_CASE("builder", "[SC][builder]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    const Simplex f0(2, t);
+    const Simplex f1(2, t.sw(2, m)); // F(013)
+
+    SimplicialComplexBuilder builder;
+    builder.add_boundary(f0, m);
+    REQUIRE(builder.finalize() == boundary(f0, m));
+    builder.add_simplex_with_boundary(f0, m);
+    REQUIRE(builder.finalize() == simplex_with_boundary(f0, m));
+
+    // duplicates across several calls are removed once, in finalize()
+    builder.add_simplex_with_boundary(f0, m);
+    builder.add_simplex_with_boundary(f1, m);
+    builder.add_boundary(f0, m);
+    builder.add_simplex(Simplex(1, t));
+    builder.add_simplex(SimplexId(Simplex(1, t)));
+    builder.add_complex(simplex_with_boundary(f1, m));
+    SimplicialComplex sc = builder.finalize();
+    REQUIRE(sc == get_union(simplex_with_boundary(f0, m), simplex_with_boundary(f1, m)));
+    REQUIRE(sc.get_size() == 2 + 5 + 4);
+
+    // the builder is empty after finalize()
+    REQUIRE(builder.finalize().get_size() == 0);
+
+    const std::vector<Tuple> tuples = {f0.tuple(), f1.tuple()};
+    builder.add_boundary(tuples, 2, m);
+    REQUIRE(builder.finalize() == boundary(tuples, 2, m));
+    builder.add_simplices_with_boundary(tuples, 2, m);
+    REQUIRE(builder.finalize() == closure({f0, f1}, m));
+}
+
+TEST_CASE("star of a subcomplex", "[SC][star][link]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    // region {V(0), V(1), E(01)}
+    SimplicialComplex region = simplex_with_boundary(Simplex(1, t), m);
+
+    SimplicialComplex clst = get_union(closed_star(Simplex(0, t), m), closed_star(Simplex(0, t.sw(0, m)), m));
+    REQUIRE(closed_star(region, m) == clst);
+
+    SimplicialComplex ost = get_union(open_star(Simplex(0, t), m), open_star(Simplex(0, t.sw(0, m)), m));
+    REQUIRE(open_star(region, m) == ost);
+
+    // region {E(01)} is not closed, its open star does not contain the stars of V(0) and V(1)
+    SimplicialComplex edge_region;
+    edge_region.add_simplex(Simplex(1, t));
+    REQUIRE(open_star(edge_region, m) == open_star(Simplex(1, t), m));
+    REQUIRE(open_star(edge_region, m).get_size() == 3); // E(01), F(013), F(012)
+
+    // region {E(01), V(4)}
+    Tuple v4 = t.sw(1, m).sw(2, m).sw(1, m).sw(0, m);
+    SimplicialComplex edge_vertex_region = edge_region;
+    edge_vertex_region.add_simplex(Simplex(0, v4));
+    REQUIRE(open_star(edge_vertex_region, m) == get_union(open_star(Simplex(1, t), m), open_star(Simplex(0, v4), m)));
+
+    // V(2), V(3), V(4), V(5), E(24) and E(25)
+    REQUIRE(link(region, m).get_size() == 6);
+}
+
+TEST_CASE("partition", "[SC][partition]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    auto parts = partition_mesh(m, 2);
+    REQUIRE(parts.size() == 2);
+    REQUIRE(parts[0].owned_cells.size() + parts[1].owned_cells.size() == 4);
+
+    for (const MeshPart &part : parts)
+    {
+        // V(0), V(1), V(2) are interface vertices and every face touches one of them
+        REQUIRE(part.owned_cells.size() + part.ghost_cells.size() == 4);
+        REQUIRE(part.local_to_global[2].size() == 4);
+        REQUIRE(part.n_owned[2] == 2);
+        for (long i = 0; i < long(part.local_to_global[0].size()); ++i)
+        {
+            REQUIRE(part.global_to_local[0].at(part.local_to_global[0][i]) == i);
+        }
+    }
+    // interface simplices have a single owner
+    REQUIRE(parts[0].n_owned[0] + parts[1].n_owned[0] == 6);
+    REQUIRE(parts[0].n_owned[1] + parts[1].n_owned[1] == 9);
+}
+
+TEST_CASE("reordering", "[SC][reordering]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    const MeshReordering r = compute_reordering(m);
+    REQUIRE(r.cell_new_to_old.size() == 4);
+    REQUIRE(r.vertex_new_to_old.size() == 6);
+    for (long i = 0; i < 4; ++i)
+    {
+        REQUIRE(r.cell_old_to_new[r.cell_new_to_old[i]] == i);
+    }
+    for (long i = 0; i < 6; ++i)
+    {
+        REQUIRE(r.vertex_old_to_new[r.vertex_new_to_old[i]] == i);
+    }
+    // F(012) is the only face with 3 neighbors, RCM puts it in between the others
+    REQUIRE(r.cell_old_to_new[1] != 0);
+    REQUIRE(r.cell_old_to_new[1] != 3);
+}
+
+TEST_CASE("persistent complex", "[SC][persistent]")
+{
+    PersistentSimplicialComplex sc;
+    for (long i = 0; i < 1000; ++i)
+    {
+        REQUIRE(sc.add_simplex(SimplexId(1, i)));
+    }
+    REQUIRE_FALSE(sc.add_simplex(SimplexId(1, 10)));
+
+    const PersistentSimplicialComplex before = sc; // snapshot
+    REQUIRE(before == sc);
+
+    REQUIRE(sc.add_simplex(SimplexId(2, 0)));
+    REQUIRE(sc.remove_simplex(SimplexId(1, 0)));
+    REQUIRE(sc.get_size() == 1000);
+    REQUIRE(before.get_size() == 1000);
+    REQUIRE(before.contains(SimplexId(1, 0)));
+    REQUIRE_FALSE(before.contains(SimplexId(2, 0)));
+    REQUIRE_FALSE(before == sc);
+
+    // only the first and the last chunk were copied
+    REQUIRE(before.n_shared_chunks(before) > 2);
+    REQUIRE(sc.n_shared_chunks(before) == before.n_shared_chunks(before) - 2);
+
+    SimplicialComplex plain = sc.to_complex();
+    REQUIRE(plain.get_size() == 1000);
+    REQUIRE(PersistentSimplicialComplex(plain) == sc);
+}
+
+TEST_CASE("batch queries", "[SC][batch]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    SimplexQueries queries;
+    queries.push_back(0, t);
+    queries.push_back(0, t.sw(0, m));
+    queries.push_back(1, t);
+
+    const auto check = [&](const QueryKind &kind, auto op) {
+        const CsrResult r = batch_query(queries, kind, m);
+        REQUIRE(r.offsets.size() == queries.size() + 1);
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            const SimplicialComplex sc = op(Simplex(queries.dimensions[i], queries.tuples[i]));
+            const std::vector<SimplexId> expected(sc.get_simplices().begin(), sc.get_simplices().end());
+            const std::vector<SimplexId> result(r.ids.begin() + r.offsets[i], r.ids.begin() + r.offsets[i + 1]);
+            REQUIRE(result == expected);
+        }
+    };
+    check(QueryKind::ClosedStar, [&](const Simplex &s) { return closed_star(s, m); });
+    check(QueryKind::OpenStar, [&](const Simplex &s) { return open_star(s, m); });
+    check(QueryKind::Link, [&](const Simplex &s) { return link(s, m); });
+
+    SimplexQueries vertices;
+    vertices.push_back(0, t);
+    vertices.push_back(0, t.sw(0, m));
+    const CsrResult r = batch_query(vertices, QueryKind::VertexOneRing, m);
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        std::vector<SimplexId> expected;
+        for (const Tuple &nt : vertex_one_ring(vertices.tuples[i], m))
+        {
+            expected.emplace_back(Simplex(0, nt));
+        }
+        std::sort(expected.begin(), expected.end());
+        const std::vector<SimplexId> result(r.ids.begin() + r.offsets[i], r.ids.begin() + r.offsets[i + 1]);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("link-cond-tet", "[SC][link]")
+{
+    auto T = {
+        {0,1,2,3},
+        {0,1,2,4}
+    }; // 2 Tets
+
+    // dump it to (Tet)Mesh
+    Mesh m(T);
+
+    // get the tuple point to V(0), E(01), F(012), T(0123)
+    long hash = 0;
+    Tuple t(0, 0, 0, 0, hash);
+
+    SimplicialComplex lnk_0 = link(Simplex(0, t), m);
+    SimplicialComplex lnk_1 = link(Simplex(0, t.sw(0, m)), m);
+    SimplicialComplex lnk_01 = link(Simplex(1, t), m);
+    REQUIRE(get_intersection(lnk_0, lnk_1) == lnk_01);
+    REQUIRE(link_cond_tet(t, m) == true);
+
+    // the fast check agrees with the definition on E(03) too
+    Tuple t03 = t.sw(2, m).sw(1, m); // V(0), E(03)
+    SimplicialComplex lhs = get_intersection(link(Simplex(0, t03), m), link(Simplex(0, t03.sw(0, m)), m));
+    REQUIRE(link_cond_tet(t03, m) == (lhs == link(Simplex(1, t03), m)));
+}
+
+TEST_CASE("boundary surface", "[SC][boundary]")
+{
+    auto T = {
+        {0,1,2,3},
+        {0,1,2,4}
+    }; // 2 Tets
+
+    // dump it to (Tet)Mesh
+    Mesh m(T);
+
+    const BoundarySurface surface = extract_boundary_surface(m);
+
+    // F(012) is shared, the other 6 faces are on the boundary
+    REQUIRE(surface.faces.size() == 6);
+    REQUIRE(surface.vertices.size() == 5);
+    REQUIRE(surface.complex.get_simplex_count(2) == 6);
+    // every edge lies on a boundary face
+    REQUIRE(surface.complex.get_simplex_count(1) == 9);
+    for (const auto &f : surface.faces)
+    {
+        for (const long &v : f)
+        {
+            REQUIRE(v >= 0);
+            REQUIRE(v < 5);
+        }
+    }
+    // the surface is closed and consistently oriented: every directed edge appears exactly once,
+    // and its reverse belongs to the neighboring triangle
+    std::set<std::pair<long, long>> directed_edges;
+    for (const auto &f : surface.faces)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            REQUIRE(directed_edges.insert({f[j], f[(j + 1) % 3]}).second);
+        }
+    }
+    for (const auto &[u, v] : directed_edges)
+    {
+        REQUIRE(directed_edges.count({v, u}) == 1);
+    }
+}
+
+TEST_CASE("manifold validation", "[SC][manifold]")
+{
+    auto T = {
+        {0,1,2,3},
+        {0,1,2,4}
+    }; // 2 Tets
+
+    // dump it to (Tet)Mesh
+    Mesh m(T);
+    REQUIRE(validate_manifold(m).is_manifold());
+
+    auto T2 = {
+        {0,1,2,3},
+        {0,4,5,6}
+    }; // 2 Tets sharing only V(0)
+
+    // dump it to (Tet)Mesh
+    Mesh m2(T2);
+    const ManifoldReport report = validate_manifold(m2);
+    REQUIRE(report.non_manifold_vertices == std::vector<long>{0});
+    REQUIRE(report.non_manifold_edges.empty());
+}
+
+TEST_CASE("batch navigation", "[SC][boundary]")
+{
+    auto T = {
+        {0,1,2,3},
+        {0,1,2,4}
+    }; // 2 Tets
+
+    // dump it to (Tet)Mesh
+    Mesh m(T);
+
+    // get the tuple point to V(0), E(01), F(012), T(0123)
+    long hash = 0;
+    Tuple t(0, 0, 0, 0, hash);
+    std::vector<Tuple> tuples = {t, t.sw(3, m)};
+
+    // lockstep switching gives the same tuples as switching one at a time
+    std::vector<Tuple> switched = tuples;
+    sw_chain(switched, {0, 2, 1}, m);
+    for (size_t i = 0; i < tuples.size(); ++i)
+    {
+        REQUIRE(Simplex(1, switched[i]).global_id() == Simplex(1, tuples[i].sw(0, m).sw(2, m).sw(1, m)).global_id());
+    }
+
+    SimplicialComplex bd = boundary(tuples, 3, m);
+    REQUIRE(bd == get_union(boundary(Simplex(3, tuples[0]), m), boundary(Simplex(3, tuples[1]), m)));
+    REQUIRE(bd.get_simplex_count(2) == 7);
+
+    // the lockstep frontier expansion still reaches every tet around V(0)
+    REQUIRE(top_cofaces(Simplex(0, t), m).size() == 2);
+    REQUIRE(closed_star(Simplex(0, t), m) == closure({Simplex(3, tuples[0]), Simplex(3, tuples[1])}, m));
+}
+
+TEST_CASE("legacy layer", "[SC][legacy]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // get the tuple point to V(0), E(01), F(012)
+    long hash = 0;
+    Tuple t(0, 2, 1, hash);
+
+    const LegacySimplex e(1, t);
+    REQUIRE(e.d == 1);
+    REQUIRE(bd(e, m) == boundary(Simplex(1, t), m));
+    REQUIRE(clbd(e, m) == simplex_with_boundary(Simplex(1, t), m));
+    REQUIRE(clst(e, m) == closed_star(Simplex(1, t), m));
+    REQUIRE(lnk(e, m) == link(Simplex(1, t), m));
+    REQUIRE(st(e, m) == open_star(Simplex(1, t), m));
+
+    LegacySimplicialComplex sc(m);
+    REQUIRE(sc.AddSimplex(LegacySimplex(0, t)));
+    REQUIRE_FALSE(sc.AddSimplex(LegacySimplex(0, t)));
+    sc.unionComplex(bd(e, m));
+    REQUIRE(sc == boundary(Simplex(1, t), m)); // V(0), V(1)
+
+    const std::vector<std::vector<Tuple>> tuples = sc.get_simplexes();
+    REQUIRE(tuples[0].size() == 2);
+    REQUIRE(SimplicialComplex(tuples[0], 0) == sc);
+}
+
+TEST_CASE("edge batches", "[SC][scheduling]")
+{
+    auto F = {
+        {0,3,1},
+        {0,1,2},
+        {0,2,4},
+        {2,1,5}
+    }; // 4 Faces
+
+    // dump it to (Tri)Mesh
+    Mesh m(F);
+
+    // edges 01, 02, 12, 25
+    long hash = 0;
+    std::vector<Tuple> edges = {
+        Tuple(0, 2, 1, hash),
+        Tuple(0, 1, 2, hash),
+        Tuple(1, 0, 1, hash),
+        Tuple(2, 1, 3, hash)
+    };
+
+    auto batches = schedule_edge_batches(edges, m);
+
+    size_t n_scheduled = 0;
+    for (const auto &batch : batches)
+    {
+        n_scheduled += batch.size();
+        std::set<long> used;
+        for (const Tuple &t : batch)
+        {
+            for (long v : closed_star_vertex_footprint(t, m))
+            {
+                REQUIRE(used.insert(v).second);
+            }
+        }
+    }
+    REQUIRE(n_scheduled == edges.size());
+    // the footprint of 25 is clst(2) ∪ clst(5), more than the closed star of the edge
+    REQUIRE(closed_star_vertex_footprint(edges[3], m) == std::vector<long>{0, 1, 2, 4, 5});
+    // every edge touches vertex 1 or 2 --> all footprints overlap
+    REQUIRE(batches.size() == edges.size());
+    REQUIRE(independent_edge_set(edges, m).size() == 1);
+}
+
 TEST_CASE("star", "[SC][open star]")
 {
 
-}
\ No newline at end of file
+}